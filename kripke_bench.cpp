@@ -0,0 +1,627 @@
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "lake.hpp"
+
+
+using Clock = std::chrono::steady_clock;
+using BenchFrame = KripkeFrame<std::size_t, PropositionLabel<2>>;
+
+static double micros_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+/// Collects result records and prints them as one JSON document.
+class BenchReport {
+
+private:
+    std::vector<std::string> m_records;
+
+public:
+    void add(const std::string &frame, const std::string &benchmark, std::size_t states, std::size_t transitions,
+             double micros, const std::string &extra = {}) {
+        std::ostringstream out;
+        out << "{\"frame\": \"" << frame << "\", \"benchmark\": \"" << benchmark << "\", \"states\": " << states
+            << ", \"transitions\": " << transitions << ", \"us\": " << micros;
+        if (!extra.empty()) {
+            out << ", " << extra;
+        }
+        out << "}";
+        m_records.push_back(out.str());
+    }
+
+    void print(std::ostream &out) const {
+        out << "{\"results\": [\n";
+        for (std::size_t i = 0; i < m_records.size(); ++i) {
+            out << "  " << m_records[i] << (i + 1 < m_records.size() ? ",\n" : "\n");
+        }
+        out << "]}" << std::endl;
+    }
+};
+
+
+// --- frame generators ---
+
+static PropositionLabel<2> random_label(std::mt19937_64 &rng) {
+    return PropositionLabel<2>(rng() % 4);
+}
+
+/// Erdős–Rényi style G(n, m) with m = n * degree uniformly random transitions.
+static BenchFrame erdos_renyi_frame(std::size_t n, std::size_t degree, std::mt19937_64 &rng) {
+    BenchFrame frame;
+    for (std::size_t v = 0; v < n; ++v) {
+        frame.add_state(v, random_label(rng));
+    }
+    for (std::size_t e = 0; e < n * degree; ++e) {
+        frame.add_transition(rng() % n, rng() % n);
+    }
+    return frame;
+}
+
+/// Chung–Lu style power law: endpoints drawn with weight (i + 1)^-alpha, so a
+/// few hub states collect most transitions.
+static BenchFrame power_law_frame(std::size_t n, std::size_t degree, double alpha, std::mt19937_64 &rng) {
+    std::vector<double> weights(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        weights[i] = std::pow(static_cast<double>(i + 1), -alpha);
+    }
+    std::discrete_distribution<std::size_t> pick(weights.begin(), weights.end());
+    std::vector<std::size_t> relabel(n);
+    std::iota(relabel.begin(), relabel.end(), 0);
+    std::shuffle(relabel.begin(), relabel.end(), rng);
+
+    BenchFrame frame;
+    for (std::size_t v = 0; v < n; ++v) {
+        frame.add_state(v, random_label(rng));
+    }
+    for (std::size_t e = 0; e < n * degree; ++e) {
+        frame.add_transition(relabel[pick(rng)], relabel[pick(rng)]);
+    }
+    return frame;
+}
+
+/// side x side torus with transitions to the four neighbours.
+static BenchFrame grid_frame(std::size_t n, std::mt19937_64 &rng) {
+    const auto side = std::max<std::size_t>(2, static_cast<std::size_t>(std::sqrt(static_cast<double>(n))));
+    BenchFrame frame;
+    for (std::size_t v = 0; v < side * side; ++v) {
+        frame.add_state(v, random_label(rng));
+    }
+    for (std::size_t r = 0; r < side; ++r) {
+        for (std::size_t c = 0; c < side; ++c) {
+            const auto v = r * side + c;
+            frame.add_transition(v, r * side + (c + 1) % side);
+            frame.add_transition(v, r * side + (c + side - 1) % side);
+            frame.add_transition(v, ((r + 1) % side) * side + c);
+            frame.add_transition(v, ((r + side - 1) % side) * side + c);
+        }
+    }
+    return frame;
+}
+
+/// Asynchronous composition of `processes` cyclic processes with `local`
+/// states each, where the last local state is a critical section guarded by
+/// a mutex: the shape of frames that come out of explicit-state exploration.
+struct MutexModel {
+    using StateType = std::size_t;
+    using LabelType = PropositionLabel<2>;
+
+    std::size_t processes;
+    std::size_t local;
+
+    [[nodiscard]] std::size_t local_state(StateType s, std::size_t p) const {
+        for (std::size_t i = 0; i < p; ++i) {
+            s /= local;
+        }
+        return s % local;
+    }
+
+    [[nodiscard]] std::vector<StateType> initial_states() const {
+        return {0};
+    }
+
+    template<typename Emit>
+    void successors(const StateType &s, Emit &&emit) const {
+        const auto critical = local - 1;
+        bool locked = false;
+        for (std::size_t p = 0; p < processes; ++p) {
+            locked = locked || local_state(s, p) == critical;
+        }
+        std::size_t weight = 1;
+        for (std::size_t p = 0; p < processes; ++p, weight *= local) {
+            const auto ls = local_state(s, p);
+            const auto next = (ls + 1) % local;
+            if (next == critical && locked) {
+                continue;
+            }
+            emit(s - ls * weight + next * weight);
+        }
+    }
+
+    [[nodiscard]] LabelType label(const StateType &s) const {
+        LabelType label;
+        label.set(0, local_state(s, 0) == local - 1);
+        label.set(1, local_state(s, 1 % processes) == 1);
+        return label;
+    }
+};
+
+
+// --- benchmarks ---
+
+static void bench_frame(BenchReport &report, const std::string &name, BenchFrame frame, double construction_us) {
+    const auto n = frame.num_states();
+    const auto m = frame.num_transitions();
+    report.add(name, "construction", n, m, construction_us);
+
+    auto start = Clock::now();
+    const auto distance = bfs_distances(frame, 0);
+    const auto reached = static_cast<std::size_t>(std::count_if(distance.begin(), distance.end(), [](auto d) {
+        return d != StateSet::npos;
+    }));
+    report.add(name, "bfs", n, m, micros_since(start), "\"reached\": " + std::to_string(reached));
+
+    start = Clock::now();
+    const auto scc = strongly_connected_components(frame);
+    report.add(name, "scc", n, m, micros_since(start), "\"components\": " + std::to_string(scc.count));
+
+    start = Clock::now();
+    const CompressedKripkeFrame<std::size_t, PropositionLabel<2>> compressed(frame, bfs_order(frame));
+    const auto compress_us = micros_since(start);
+    start = Clock::now();
+    const auto compressed_distance = bfs_distances(compressed, compressed.renumbering()[0]);
+    report.add(name, "compressed_bfs", n, m, micros_since(start),
+               "\"compress_us\": " + std::to_string(compress_us) +
+               ", \"csr_bytes\": " + std::to_string((n + 1 + m) * sizeof(std::size_t)) +
+               ", \"compressed_bytes\": " + std::to_string(compressed.adjacency_bytes()));
+
+    start = Clock::now();
+    frame.build_predecessor_index();
+    report.add(name, "predecessor_index", n, m, micros_since(start));
+
+    start = Clock::now();
+    CtlChecker checker(frame);
+    const auto p = checker.atom(0);
+    const auto q = checker.atom(1);
+    const auto eu = checker.eu(p, q);
+    const auto eg = checker.eg(p);
+    const auto ag_ef = checker.ag(checker.ef(q));
+    report.add(name, "ctl", n, m, micros_since(start),
+               "\"eu\": " + std::to_string(eu.count()) + ", \"eg\": " + std::to_string(eg.count()) +
+               ", \"ag_ef\": " + std::to_string(ag_ef.count()));
+}
+
+template<typename Make>
+static void bench_generated(BenchReport &report, const std::string &name, Make &&make) {
+    const auto start = Clock::now();
+    auto frame = make();
+    const auto construction = micros_since(start);
+    bench_frame(report, name, std::move(frame), construction);
+}
+
+/// Frame of `components` disjoint random subgraphs, the shape of a model
+/// whose processes rarely interact; an edit only affects its own component.
+static BenchFrame component_frame(std::size_t components, std::size_t size,
+                                  std::size_t degree, std::mt19937_64 &rng) {
+    BenchFrame frame;
+    for (std::size_t v = 0; v < components * size; ++v) {
+        frame.add_state(v, random_label(rng));
+    }
+    for (std::size_t v = 0; v < components * size; ++v) {
+        const std::size_t base = v / size * size;
+        for (std::size_t k = 0; k < degree; ++k) {
+            frame.add_transition(v, base + rng() % size);
+        }
+    }
+    return frame;
+}
+
+/// Edit-recheck latency: one add_transition followed by a query, compared
+/// with re-running the same formulas from scratch with CtlChecker.
+static void bench_incremental_recheck(BenchReport &report, std::size_t states, std::size_t edits) {
+    constexpr std::size_t component_size = 200;
+    std::mt19937_64 rng(42);
+    const auto components = std::max<std::size_t>(1, states / component_size);
+    IncrementalCtlChecker checker(component_frame(components, component_size, 4, rng));
+    const auto p = checker.atom(0);
+    const auto q = checker.atom(1);
+    const auto ef_p = checker.eu(checker.constant(true), p);
+    checker.eg(checker.negation(q));
+    checker.eu(p, q);
+
+    double incremental = 0;
+    double full = 0;
+    std::size_t affected = 0;
+    for (std::size_t e = 0; e < edits; ++e) {
+        const std::size_t from = rng() % (components * component_size);
+        checker.add_transition(from, from / component_size * component_size + rng() % component_size);
+
+        auto start = Clock::now();
+        (void) checker.satisfying(ef_p);
+        incremental += micros_since(start);
+        affected += checker.last_recheck().affected_states;
+
+        start = Clock::now();
+        CtlChecker scratch(checker.frame());
+        const auto ps = scratch.atom(0);
+        const auto qs = scratch.atom(1);
+        (void) scratch.ef(ps);
+        (void) scratch.eg(~qs);
+        (void) scratch.eu(ps, qs);
+        full += micros_since(start);
+    }
+
+    const auto mean = [&](double total) { return std::to_string(total / static_cast<double>(edits)); };
+    report.add("components", "incremental_recheck", checker.frame().num_states(), checker.frame().num_transitions(),
+               incremental / static_cast<double>(edits),
+               "\"edits\": " + std::to_string(edits) + ", \"mean_affected_states\": " + mean(static_cast<double>(affected)) +
+               ", \"mean_full_us\": " + mean(full));
+}
+
+
+/// Traversal cost on a power-law frame in its (random) generation order and
+/// after each reordering: SCC plus the CTL fixpoints of bench_frame.
+static void bench_reorder(BenchReport &report, std::size_t states, std::size_t degree, std::mt19937_64 &rng) {
+    const auto original = power_law_frame(states, degree, 1.0, rng);
+    const auto traverse = [](const BenchFrame &frame) {
+        const auto start = Clock::now();
+        (void) strongly_connected_components(frame);
+        CtlChecker checker(frame);
+        (void) checker.eu(checker.atom(0), checker.atom(1));
+        (void) checker.eg(checker.atom(0));
+        (void) checker.ag(checker.ef(checker.atom(1)));
+        return micros_since(start);
+    };
+    const auto n = original.num_states();
+    const auto m = original.num_transitions();
+    report.add("power_law", "traversal_original", n, m, traverse(original));
+
+    const std::pair<const char *, StateOrder> orders[] = {
+            {"bfs", StateOrder::bfs},
+            {"reverse_cuthill_mckee", StateOrder::reverse_cuthill_mckee},
+            {"gorder", StateOrder::gorder},
+    };
+    for (const auto &[name, kind]: orders) {
+        auto frame = original;
+        const auto start = Clock::now();
+        (void) reorder(frame, kind);
+        const auto reorder_us = micros_since(start);
+        report.add("power_law", std::string("traversal_") + name, n, m, traverse(frame),
+                   "\"reorder_us\": " + std::to_string(reorder_us));
+    }
+}
+
+
+/// Frame construction from a random edge list: add_transition per edge
+/// against KripkeFrameBuilder's sort-and-pack into CSR.
+static void bench_bulk_build(BenchReport &report, std::size_t states, std::size_t degree, std::mt19937_64 &rng) {
+    std::vector<std::size_t> from(states * degree), to(states * degree);
+    for (std::size_t e = 0; e < from.size(); ++e) {
+        from[e] = rng() % states;
+        to[e] = rng() % states;
+    }
+
+    auto start = Clock::now();
+    BenchFrame incremental;
+    for (std::size_t v = 0; v < states; ++v) {
+        incremental.add_state(v, {});
+    }
+    for (std::size_t e = 0; e < from.size(); ++e) {
+        incremental.add_transition(from[e], to[e]);
+    }
+    const auto incremental_us = micros_since(start);
+
+    start = Clock::now();
+    KripkeFrameBuilder<std::size_t, PropositionLabel<2>> builder;
+    builder.add_edges(from, to);
+    const auto frame = std::move(builder).build();
+    report.add("edge_list", "bulk_build", frame.num_states(), frame.num_transitions(), micros_since(start),
+               "\"add_transition_us\": " + std::to_string(incremental_us));
+}
+
+
+/// Reachability queries on a random DAG with a few back edges: a BFS per
+/// query against ReachabilityIndex, once with interval labels on the whole
+/// frame and once with the bitset closure on a frame under closure_limit.
+static void bench_reachability_index(BenchReport &report, std::size_t states, std::size_t degree,
+                                     std::mt19937_64 &rng) {
+    const auto dag_frame = [&](std::size_t n) {
+        BenchFrame frame;
+        for (std::size_t v = 0; v < n; ++v) {
+            frame.add_state(v, random_label(rng));
+        }
+        for (std::size_t v = 1; v < n; ++v) {
+            for (std::size_t k = 0; k < degree; ++k) {
+                frame.add_transition(v, rng() % v);
+            }
+            if (rng() % 64 == 0) {
+                frame.add_transition(rng() % v, v);
+            }
+        }
+        return frame;
+    };
+    constexpr std::size_t queries = 100000;
+    constexpr std::size_t bfs_queries = 100;
+    const ReachabilityIndexOptions options;
+    for (const auto n: {states, std::min(states, options.closure_limit)}) {
+        const auto frame = dag_frame(n);
+        auto start = Clock::now();
+        const ReachabilityIndex index(frame, options);
+        const auto build_us = micros_since(start);
+
+        std::size_t positive = 0;
+        start = Clock::now();
+        for (std::size_t q = 0; q < queries; ++q) {
+            positive += index.reaches(rng() % n, rng() % n);
+        }
+        const auto query_us = micros_since(start) / queries;
+
+        start = Clock::now();
+        for (std::size_t q = 0; q < bfs_queries; ++q) {
+            const auto target = rng() % n;
+            (void) bfs_distances(frame, rng() % n)[target];
+        }
+        const auto bfs_us = micros_since(start) / bfs_queries;
+        report.add("dag", index.uses_closure() ? "reachability_closure" : "reachability_intervals", n,
+                   frame.num_transitions(), query_us,
+                   "\"build_us\": " + std::to_string(build_us) + ", \"components\": " +
+                   std::to_string(index.num_components()) + ", \"index_bytes\": " +
+                   std::to_string(index.memory_bytes()) + ", \"bfs_us\": " + std::to_string(bfs_us) +
+                   ", \"positive_queries\": " + std::to_string(positive));
+    }
+}
+
+
+/// Number of states whose EG p, E[p U q] or AG EF q verdict in the quotient
+/// differs from the one in frame.
+static std::size_t quotient_mismatches(const BenchFrame &frame,
+                                       const BisimulationQuotient<std::size_t, PropositionLabel<2>> &quotient) {
+    const CtlChecker original(frame);
+    const CtlChecker reduced(quotient.frame);
+    const auto formulas = [](const CtlChecker<BenchFrame> &checker) {
+        const auto p = checker.atom(0);
+        const auto q = checker.atom(1);
+        return std::array{checker.eg(p), checker.eu(p, q), checker.ag(checker.ef(q))};
+    };
+    const auto expected = formulas(original);
+    const auto actual = formulas(reduced);
+    std::size_t mismatches = 0;
+    for (std::size_t v = 0; v < frame.num_states(); ++v) {
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            if (expected[i].test(v) != actual[i].test(quotient.block_of[v])) {
+                ++mismatches;
+                break;
+            }
+        }
+    }
+    return mismatches;
+}
+
+/// Stuttering minimization of a random frame where proposition 0 holds in
+/// most states, so long inert paths and cycles are common. The quotient is
+/// checked against the original, together with a frame where a p-state with
+/// a p self-loop and one without it share their only visible successor:
+/// EG p separates them, so they must not be merged.
+static void bench_stutter_minimize(BenchReport &report, std::size_t states, std::size_t degree,
+                                   std::mt19937_64 &rng) {
+    BenchFrame frame;
+    for (std::size_t v = 0; v < states; ++v) {
+        frame.add_state(v, PropositionLabel<2>(rng() % 8 == 0 ? 2 : 1));
+    }
+    for (std::size_t e = 0; e < states * degree; ++e) {
+        frame.add_transition(rng() % states, rng() % states);
+    }
+
+    const auto start = Clock::now();
+    const auto quotient = minimize(frame, Bisimulation::stutter);
+    const auto minimize_us = micros_since(start);
+    auto mismatches = quotient_mismatches(frame, quotient);
+
+    BenchFrame divergence;
+    divergence.add_state(0, PropositionLabel<2>(1));
+    divergence.add_state(1, PropositionLabel<2>(1));
+    divergence.add_state(2, PropositionLabel<2>(2));
+    divergence.add_transition(0, 0);
+    divergence.add_transition(0, 2);
+    divergence.add_transition(1, 2);
+    divergence.add_transition(2, 2);
+    mismatches += quotient_mismatches(divergence, minimize(divergence, Bisimulation::stutter));
+    if (mismatches != 0) {
+        std::cerr << "stutter quotient disagrees with the original frame in " << mismatches << " states" << std::endl;
+    }
+    report.add("stutter", "stutter_minimize", frame.num_states(), frame.num_transitions(), minimize_us,
+               "\"blocks\": " + std::to_string(quotient.frame.num_states()) +
+               ", \"mismatches\": " + std::to_string(mismatches));
+}
+
+
+/// Interleaving product of four random components synchronized on
+/// proposition 0: FrameProduct::build against lazy StateSpaceExplorer
+/// materialization of the same product.
+static void bench_product(BenchReport &report, std::size_t states, std::size_t degree, std::mt19937_64 &rng) {
+    constexpr std::size_t components = 4;
+    const auto size = std::max<std::size_t>(2, static_cast<std::size_t>(std::pow(static_cast<double>(states), 0.25)));
+    std::vector<BenchFrame> frames;
+    for (std::size_t i = 0; i < components; ++i) {
+        frames.push_back(erdos_renyi_frame(size, degree, rng));
+    }
+    FrameProduct<BenchFrame> product(Composition::interleaving, PropositionLabel<2>(1));
+    for (const auto &frame: frames) {
+        // Start every component in a state where proposition 0 is false, so the initial states agree.
+        std::size_t initial = 0;
+        while (initial + 1 < frame.num_states() && frame.get_label(initial).test(0)) {
+            ++initial;
+        }
+        (void) product.add_component(frame, {initial});
+    }
+
+    auto start = Clock::now();
+    ExplorationStats stats;
+    const auto frame = product.build(std::numeric_limits<std::size_t>::max(), &stats);
+    const auto build_us = micros_since(start);
+
+    start = Clock::now();
+    const auto lazy = StateSpaceExplorer(product).build_frame();
+    report.add("product", "product_build", frame.num_states(), frame.num_transitions(), build_us,
+               "\"components\": " + std::to_string(components) + ", \"component_states\": " + std::to_string(size) +
+               ", \"explorer_us\": " + std::to_string(micros_since(start)) +
+               ", \"explorer_states\": " + std::to_string(lazy.num_states()));
+}
+
+
+/// Exact frame construction from the mutex model through an interning
+/// frame, which doubles as the BFS queue, against StateSpaceExplorer's
+/// build_frame, which interns the same way behind its state limit.
+static void bench_interned_build(BenchReport &report, const MutexModel &model) {
+    auto start = Clock::now();
+    const auto explored = StateSpaceExplorer(model).build_frame();
+    const auto explorer_us = micros_since(start);
+
+    start = Clock::now();
+    BenchFrame frame;
+    frame.enable_interning();
+    for (const auto &state: model.initial_states()) {
+        (void) frame.add_state(state, model.label(state));
+    }
+    for (std::size_t v = 0; v < frame.num_states(); ++v) {
+        const auto state = frame.get_state(v);
+        model.successors(state, [&](const MutexModel::StateType &succ) {
+            frame.add_transition(v, frame.add_state(succ, model.label(succ)));
+        });
+    }
+    report.add("mutex_model", "interned_build", frame.num_states(), frame.num_transitions(), micros_since(start),
+               "\"explorer_us\": " + std::to_string(explorer_us) +
+               ", \"explorer_states\": " + std::to_string(explored.num_states()));
+}
+
+
+/// Exploration of the mutex model held entirely in memory against
+/// ExternalMemoryExplorer with a successor buffer of 1/16 of the state space.
+static void bench_external_memory(BenchReport &report, const MutexModel &model) {
+    auto start = Clock::now();
+    const auto in_memory = StateSpaceExplorer(model).explore();
+    const auto in_memory_us = micros_since(start);
+
+    ExternalMemoryOptions options;
+    options.directory = std::filesystem::temp_directory_path() / "kripke_bench_external";
+    options.memory_bytes = std::max<std::size_t>(in_memory.states / 16, 1) * sizeof(MutexModel::StateType);
+    std::error_code ignored;
+    std::filesystem::create_directories(options.directory, ignored);
+    start = Clock::now();
+    const auto stats = ExternalMemoryExplorer(model, options).explore();
+    const auto external_us = micros_since(start);
+    std::filesystem::remove(options.directory, ignored);
+    if (!stats) {
+        std::cerr << "external exploration failed in " << options.directory << std::endl;
+        return;
+    }
+    report.add("mutex_model", "external_bfs", stats->states, stats->transitions, external_us,
+               "\"levels\": " + std::to_string(stats->levels) + ", \"runs\": " + std::to_string(stats->runs) +
+               ", \"bytes_read\": " + std::to_string(stats->bytes_read) + ", \"bytes_written\": " +
+               std::to_string(stats->bytes_written) + ", \"in_memory_us\": " + std::to_string(in_memory_us));
+}
+
+
+static constexpr const char *usage =
+        "usage: kripke_bench [--states N] [--degree D] [--seed S] [--only FRAME]\n"
+        "  FRAME is one of erdos_renyi, power_law, grid, mutex_model, reorder, edge_list,\n"
+        "  components, dag, product, stutter";
+
+/// Parses all of text as an unsigned number.
+static std::optional<std::uint64_t> parse_count(const std::string &text) {
+    std::uint64_t value = 0;
+    const auto *last = text.data() + text.size();
+    const auto [end, error] = std::from_chars(text.data(), last, value);
+    if (text.empty() || error != std::errc() || end != last) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+int main(int argc, char **argv) {
+    std::size_t states = 200000;
+    std::size_t degree = 4;
+    std::uint64_t seed = 42;
+    std::string only;
+    for (int i = 1; i < argc; i += 2) {
+        const std::string flag = argv[i];
+        if (flag == "--help" || flag == "-h") {
+            std::cout << usage << std::endl;
+            return 0x0;
+        }
+        if (i + 1 == argc) {
+            std::cerr << "missing value for " << flag << "\n" << usage << std::endl;
+            return 1;
+        }
+        const std::string value = argv[i + 1];
+        if (flag == "--only") {
+            only = value;
+            continue;
+        }
+        if (flag != "--states" && flag != "--degree" && flag != "--seed") {
+            std::cerr << "unknown option " << flag << "\n" << usage << std::endl;
+            return 1;
+        }
+        const auto number = parse_count(value);
+        if (!number) {
+            std::cerr << "invalid number " << value << " for " << flag << "\n" << usage << std::endl;
+            return 1;
+        }
+        if (flag == "--states") {
+            states = *number;
+        } else if (flag == "--degree") {
+            degree = *number;
+        } else {
+            seed = *number;
+        }
+    }
+    auto selected = [&](const std::string &name) { return only.empty() || only == name; };
+
+    BenchReport report;
+    std::mt19937_64 rng(seed);
+    if (selected("erdos_renyi")) {
+        bench_generated(report, "erdos_renyi", [&] { return erdos_renyi_frame(states, degree, rng); });
+    }
+    if (selected("power_law")) {
+        bench_generated(report, "power_law", [&] { return power_law_frame(states, degree, 1.0, rng); });
+    }
+    if (selected("grid")) {
+        bench_generated(report, "grid", [&] { return grid_frame(states, rng); });
+    }
+    if (selected("mutex_model")) {
+        const std::size_t local = 4;
+        std::size_t processes = 1;
+        while (static_cast<double>(processes + 1) * std::log(local) <= std::log(static_cast<double>(states))) {
+            ++processes;
+        }
+        const MutexModel model{processes, local};
+        bench_generated(report, "mutex_model", [&] { return StateSpaceExplorer(model).build_frame(); });
+        bench_interned_build(report, model);
+        bench_external_memory(report, model);
+    }
+    if (selected("reorder")) {
+        bench_reorder(report, states, degree, rng);
+    }
+    if (selected("edge_list")) {
+        bench_bulk_build(report, states, degree, rng);
+    }
+    if (selected("components")) {
+        bench_incremental_recheck(report, states, 100);
+    }
+    if (selected("dag")) {
+        bench_reachability_index(report, states, degree, rng);
+    }
+    if (selected("product")) {
+        bench_product(report, states, degree, rng);
+    }
+    if (selected("stutter")) {
+        bench_stutter_minimize(report, states, degree, rng);
+    }
+    report.print(std::cout);
+    return 0x0;
+}
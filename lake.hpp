@@ -0,0 +1,8185 @@
+#pragma once
+
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+#include <fstream>
+#include <string>
+#include <concepts>
+#include <type_traits>
+#include <filesystem>
+#include <map>
+#include <variant>
+#include <memory>
+#include <functional>
+#include <cmath>
+#include <span>
+#include <ranges>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <numeric>
+#include <bitset>
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include <mutex>
+#include <deque>
+#include <optional>
+#include <tuple>
+#include <array>
+#include <chrono>
+#include <random>
+#include <cstddef>
+#include <cassert>
+#include <limits>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+template<typename Key, typename Value,
+        typename InsertPolicy = std::ostream &(*)(std::ostream &, const Value &),
+        typename ExtractPolicy = std::istream &(*)(std::istream &, Value &)>
+class DataLake {
+
+private:
+    /// The path to the file
+    std::filesystem::path path;
+
+    /// The map
+    std::unordered_map<Key, Value> map;
+
+    /// The insert policy
+    InsertPolicy insertPolicy;
+
+    /// The extract policy
+    ExtractPolicy extractPolicy;
+
+    /// The lake index
+    std::map<Key, std::vector<std::streamoff>> m_index;
+
+    /// The last used file
+    std::filesystem::path m_filename;
+
+    /// The directory where the files are stored
+    std::filesystem::path m_directory;
+
+public:
+    explicit DataLake(const std::filesystem::path &path) : path(path) {
+        std::ifstream file(path);
+        if (file.is_open()) {
+            Value value;
+            while (extractPolicy(file, value)) {
+                map.insert({value.getKey(), value});
+            }
+        }
+    }
+
+public:
+    void insert(const Key &key, const Value &value) {
+        std::ofstream out(m_filename, std::ios::app | std::ios_base::binary);
+        if (out.is_open()) {
+            insertPolicy(out, value);
+            m_index(key, value);
+        }
+    }
+
+    std::vector<Value> operator[](const Key &key) const {
+        std::vector<Value> values;
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            for (auto offset: it->second) {
+                std::ifstream in(m_filename, std::ios::binary);
+                if (in.is_open()) {
+                    in.seekg(offset);
+                    Value value;
+                    extractPolicy(in, value);
+                    values.push_back(value);
+                }
+            }
+        }
+        return values;
+    }
+
+    void remove(const Key &key) {
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            m_index.erase(it);
+        }
+    }
+
+    void clear_index() {
+        m_index.clear();
+    }
+
+    void index_directory(const std::filesystem::path &d) {
+        m_directory = d;
+        for (const auto &entry: std::filesystem::directory_iterator(d)) {
+            if (entry.is_regular_file()) {
+                m_filename = entry.path();
+                std::ifstream in(m_filename, std::ios::binary);
+                if (in.is_open()) {
+                    Value value;
+                    while (extractPolicy(in, value)) {
+                        m_index(value.getKey(), in.tellg());
+                    }
+                }
+            }
+        }
+    }
+
+
+private:
+    std::streamoff getOffset(const Key &key) {
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            return it->second.back();
+        }
+        return -1;
+    }
+
+private:
+    std::streamoff get_fsize(const std::filesystem::path &p) {
+        std::ifstream in(p, std::ios::binary | std::ios::ate);
+        return in.tellg();
+    }
+
+};
+
+
+/// Runs fn(i) for every i in [first, last), splitting the range into contiguous
+/// chunks over the available hardware threads. Small ranges run inline.
+template<typename Fn>
+void parallel_for(std::size_t first, std::size_t last, Fn &&fn, std::size_t grain = 4096) {
+    if (last <= first) {
+        return;
+    }
+    const std::size_t count = last - first;
+    const std::size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t workers = std::min(hw, (count + grain - 1) / grain);
+    if (workers <= 1) {
+        for (std::size_t i = first; i < last; ++i) {
+            fn(i);
+        }
+        return;
+    }
+    const std::size_t chunk = (count + workers - 1) / workers;
+    std::vector<std::jthread> threads;
+    threads.reserve(workers);
+    for (std::size_t w = 0; w < workers; ++w) {
+        const std::size_t lo = first + w * chunk;
+        const std::size_t hi = std::min(last, lo + chunk);
+        threads.emplace_back([lo, hi, &fn] {
+            for (std::size_t i = lo; i < hi; ++i) {
+                fn(i);
+            }
+        });
+    }
+}
+
+
+/// Stable LSD radix sort of keys on their low key_bits bits. Every pass
+/// counts digits per worker chunk, so the scatter runs in parallel and
+/// stays stable; passes whose digit is the same for every key are skipped.
+inline void parallel_radix_sort(std::vector<std::size_t> &keys, unsigned key_bits) {
+    constexpr unsigned max_digit_bits = 11;
+    const std::size_t n = keys.size();
+    if (n < 2 || key_bits == 0) {
+        return;
+    }
+    const unsigned passes = (key_bits + max_digit_bits - 1) / max_digit_bits;
+    const unsigned digit_bits = (key_bits + passes - 1) / passes;
+    const std::size_t radix = std::size_t{1} << digit_bits;
+    const std::size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t workers = std::clamp<std::size_t>(n / 65536, 1, hw);
+    const std::size_t chunk = (n + workers - 1) / workers;
+
+    std::vector<std::size_t> scratch(n);
+    std::vector<std::size_t> offsets(workers * radix);
+    for (unsigned shift = 0; shift < key_bits; shift += digit_bits) {
+        const auto digit = [&](std::size_t key) { return (key >> shift) & (radix - 1); };
+        std::fill(offsets.begin(), offsets.end(), 0);
+        parallel_for(0, workers, [&](std::size_t w) {
+            auto *count = offsets.data() + w * radix;
+            for (std::size_t i = w * chunk; i < std::min(n, (w + 1) * chunk); ++i) {
+                ++count[digit(keys[i])];
+            }
+        }, 1);
+        std::size_t total = 0;
+        bool trivial = false;
+        for (std::size_t d = 0; d < radix; ++d) {
+            const auto start = total;
+            for (std::size_t w = 0; w < workers; ++w) {
+                total += std::exchange(offsets[w * radix + d], total);
+            }
+            trivial = trivial || total - start == n;
+        }
+        if (trivial) {
+            continue;
+        }
+        parallel_for(0, workers, [&](std::size_t w) {
+            auto *next = offsets.data() + w * radix;
+            for (std::size_t i = w * chunk; i < std::min(n, (w + 1) * chunk); ++i) {
+                scratch[next[digit(keys[i])]++] = keys[i];
+            }
+        }, 1);
+        keys.swap(scratch);
+    }
+}
+
+/// Finalizer of splitmix64; spreads weak hashes (e.g. std::hash<int>) over all bits.
+constexpr std::uint64_t mix64(std::uint64_t x) noexcept {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+/// A dynamically sized bitset over state indices.
+class StateSet {
+
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+private:
+    std::vector<std::uint64_t> m_words;
+    std::size_t m_size = 0;
+
+    void clear_tail() {
+        if (m_size % 64 != 0) {
+            m_words.back() &= (std::uint64_t{1} << (m_size % 64)) - 1;
+        }
+    }
+
+public:
+    StateSet() = default;
+
+    explicit StateSet(std::size_t size, bool value = false)
+            : m_words((size + 63) / 64, value ? ~std::uint64_t{0} : 0), m_size(size) {
+        clear_tail();
+    }
+
+    /// Copies size bits from a word array.
+    StateSet(std::span<const std::uint64_t> words, std::size_t size)
+            : m_words(words.begin(), words.end()), m_size(size) {
+        if (!m_words.empty()) {
+            clear_tail();
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_size;
+    }
+
+    void resize(std::size_t size) {
+        m_words.resize((size + 63) / 64, 0);
+        m_size = size;
+        if (!m_words.empty()) {
+            clear_tail();
+        }
+    }
+
+    void push_back(bool value) {
+        if (m_size % 64 == 0) {
+            m_words.push_back(0);
+        }
+        ++m_size;
+        set(m_size - 1, value);
+    }
+
+    [[nodiscard]] bool test(std::size_t idx) const {
+        return (m_words[idx / 64] >> (idx % 64)) & 1u;
+    }
+
+    [[nodiscard]] bool operator[](std::size_t idx) const {
+        return test(idx);
+    }
+
+    void set(std::size_t idx) {
+        m_words[idx / 64] |= std::uint64_t{1} << (idx % 64);
+    }
+
+    void set(std::size_t idx, bool value) {
+        if (value) {
+            set(idx);
+        } else {
+            reset(idx);
+        }
+    }
+
+    void reset(std::size_t idx) {
+        m_words[idx / 64] &= ~(std::uint64_t{1} << (idx % 64));
+    }
+
+    /// Sets idx and reports whether it was previously unset.
+    bool insert(std::size_t idx) {
+        auto &word = m_words[idx / 64];
+        const auto mask = std::uint64_t{1} << (idx % 64);
+        const bool fresh = (word & mask) == 0;
+        word |= mask;
+        return fresh;
+    }
+
+    void fill(bool value) {
+        std::fill(m_words.begin(), m_words.end(), value ? ~std::uint64_t{0} : 0);
+        if (!m_words.empty()) {
+            clear_tail();
+        }
+    }
+
+    [[nodiscard]] std::size_t count() const {
+        std::size_t total = 0;
+        for (auto word: m_words) {
+            total += static_cast<std::size_t>(std::popcount(word));
+        }
+        return total;
+    }
+
+    [[nodiscard]] bool any() const {
+        return std::any_of(m_words.begin(), m_words.end(), [](auto word) { return word != 0; });
+    }
+
+    [[nodiscard]] bool none() const {
+        return !any();
+    }
+
+    /// First member at or after idx, or npos.
+    [[nodiscard]] std::size_t find_next(std::size_t idx) const {
+        if (idx >= m_size) {
+            return npos;
+        }
+        std::size_t w = idx / 64;
+        std::uint64_t word = m_words[w] & (~std::uint64_t{0} << (idx % 64));
+        while (word == 0) {
+            if (++w == m_words.size()) {
+                return npos;
+            }
+            word = m_words[w];
+        }
+        return w * 64 + static_cast<std::size_t>(std::countr_zero(word));
+    }
+
+    [[nodiscard]] std::size_t find_first() const {
+        return find_next(0);
+    }
+
+    template<typename Fn>
+    void for_each(Fn &&fn) const {
+        for (std::size_t w = 0; w < m_words.size(); ++w) {
+            for (std::uint64_t word = m_words[w]; word != 0; word &= word - 1) {
+                fn(w * 64 + static_cast<std::size_t>(std::countr_zero(word)));
+            }
+        }
+    }
+
+    [[nodiscard]] auto words() const noexcept -> std::span<const std::uint64_t> {
+        return m_words;
+    }
+
+    [[nodiscard]] auto words() noexcept -> std::span<std::uint64_t> {
+        return m_words;
+    }
+
+    StateSet &operator&=(const StateSet &other) {
+        for (std::size_t w = 0; w < m_words.size(); ++w) {
+            m_words[w] &= other.m_words[w];
+        }
+        return *this;
+    }
+
+    StateSet &operator|=(const StateSet &other) {
+        for (std::size_t w = 0; w < m_words.size(); ++w) {
+            m_words[w] |= other.m_words[w];
+        }
+        return *this;
+    }
+
+    /// Set difference.
+    StateSet &operator-=(const StateSet &other) {
+        for (std::size_t w = 0; w < m_words.size(); ++w) {
+            m_words[w] &= ~other.m_words[w];
+        }
+        return *this;
+    }
+
+    [[nodiscard]] StateSet operator~() const {
+        StateSet result(*this);
+        for (auto &word: result.m_words) {
+            word = ~word;
+        }
+        if (!result.m_words.empty()) {
+            result.clear_tail();
+        }
+        return result;
+    }
+
+    friend StateSet operator&(StateSet lhs, const StateSet &rhs) {
+        return lhs &= rhs;
+    }
+
+    friend StateSet operator|(StateSet lhs, const StateSet &rhs) {
+        return lhs |= rhs;
+    }
+
+    friend StateSet operator-(StateSet lhs, const StateSet &rhs) {
+        return lhs -= rhs;
+    }
+
+    friend bool operator==(const StateSet &, const StateSet &) = default;
+};
+
+
+/// Label type selecting the atomic-proposition label mode of KripkeFrame:
+/// bit p of a state's label is set iff proposition p holds in that state.
+template<std::size_t NumPropositions>
+using PropositionLabel = std::bitset<NumPropositions>;
+
+template<typename T>
+struct is_proposition_label : std::false_type {};
+
+template<std::size_t N>
+struct is_proposition_label<std::bitset<N>> : std::true_type {};
+
+template<typename T>
+inline constexpr bool is_proposition_label_v = is_proposition_label<T>::value;
+
+
+template<typename State, typename Label>
+class KripkeFrameBuilder;
+
+
+template<
+        typename State,
+        typename Label
+>
+class KripkeFrame {
+
+    friend class KripkeFrameBuilder<State, Label>;
+
+
+public:
+    using StateType = State;
+    using LabelType = Label;
+
+    /// With PropositionLabel labels are stored column-wise: one StateSet per
+    /// proposition, which doubles as the proposition -> states index.
+    static constexpr bool has_proposition_labels = is_proposition_label_v<Label>;
+
+private:
+    std::vector<StateType> m_states;
+    std::vector<LabelType> m_labels;
+    std::vector<std::vector<std::size_t>> m_transitions;
+
+    /// Forward adjacency in CSR form, used instead of m_transitions once the
+    /// frame is compacted or built in bulk; m_succ_offsets is empty otherwise.
+    std::vector<std::size_t> m_succ_offsets;
+    std::vector<std::size_t> m_succ_targets;
+
+    /// Reverse adjacency in CSR form, built on demand by predecessors().
+    /// m_pred_sources[m_pred_offsets[v] .. m_pred_offsets[v + 1]) holds the
+    /// sorted sources of every transition into v.
+    mutable std::vector<std::size_t> m_pred_offsets;
+    mutable std::vector<std::size_t> m_pred_sources;
+    mutable bool m_pred_valid = false;
+
+    /// Edits made while the reverse CSR is current. A target's first new
+    /// transition copies its CSR row here, and from then on this list,
+    /// kept sorted, replaces the row. Empty until the first such edit;
+    /// folded back into the CSR by compact() and dropped on a full rebuild.
+    mutable std::vector<std::vector<std::size_t>> m_pred_overlay;
+
+    /// Proposition columns, only populated when has_proposition_labels.
+    std::vector<StateSet> m_label_index;
+
+    /// Interning index, empty unless enabled: open addressing over state
+    /// index + 1 (0 marks a free slot). Every state's hash is cached in
+    /// m_state_hashes, so probes compare hashes before states and growing
+    /// never rehashes a state.
+    std::vector<std::size_t> m_intern_slots;
+    std::vector<std::uint64_t> m_state_hashes;
+
+    [[nodiscard]] bool is_compact() const noexcept {
+        return !m_succ_offsets.empty();
+    }
+
+    void append_successor_list() {
+        if (is_compact()) {
+            m_succ_offsets.push_back(m_succ_offsets.back());
+        } else {
+            m_transitions.emplace_back();
+        }
+        if (m_pred_valid) {
+            m_pred_offsets.push_back(m_pred_offsets.back());
+            if (!m_pred_overlay.empty()) {
+                m_pred_overlay.emplace_back();
+            }
+        }
+    }
+
+    /// Discards the reverse index; the next predecessors() rebuilds it.
+    void invalidate_predecessors() noexcept {
+        m_pred_valid = false;
+        m_pred_overlay = {};
+    }
+
+    /// Records from -> to in the reverse index, if there is one.
+    void add_predecessor(std::size_t from, std::size_t to) {
+        if (!m_pred_valid) {
+            return;
+        }
+        if (m_pred_overlay.empty()) {
+            m_pred_overlay.resize(m_states.size());
+        }
+        auto &row = m_pred_overlay[to];
+        if (row.empty()) {
+            row.assign(m_pred_sources.begin() + static_cast<std::ptrdiff_t>(m_pred_offsets[to]),
+                       m_pred_sources.begin() + static_cast<std::ptrdiff_t>(m_pred_offsets[to + 1]));
+        }
+        row.insert(std::upper_bound(row.begin(), row.end(), from), from);
+    }
+
+    /// Rewrites the reverse CSR with the overlay rows in place of their
+    /// originals.
+    void merge_predecessor_overlay() {
+        if (m_pred_overlay.empty()) {
+            return;
+        }
+        const std::size_t n = m_states.size();
+        std::vector<std::size_t> offsets(n + 1, 0);
+        for (std::size_t v = 0; v < n; ++v) {
+            offsets[v + 1] = offsets[v] + predecessors(v).size();
+        }
+        std::vector<std::size_t> sources(offsets[n]);
+        parallel_for(0, n, [&](std::size_t v) {
+            std::ranges::copy(predecessors(v), sources.begin() + static_cast<std::ptrdiff_t>(offsets[v]));
+        });
+        m_pred_offsets = std::move(offsets);
+        m_pred_sources = std::move(sources);
+        m_pred_overlay = {};
+    }
+
+    /// Moves CSR adjacency back into per-state lists so it can be edited.
+    void expand() {
+        if (!is_compact()) {
+            return;
+        }
+        m_transitions.resize(m_states.size());
+        for (std::size_t v = 0; v < m_states.size(); ++v) {
+            m_transitions[v].assign(m_succ_targets.begin() + static_cast<std::ptrdiff_t>(m_succ_offsets[v]),
+                                    m_succ_targets.begin() + static_cast<std::ptrdiff_t>(m_succ_offsets[v + 1]));
+        }
+        m_succ_offsets = {};
+        m_succ_targets = {};
+    }
+
+    [[nodiscard]] static std::uint64_t state_hash(const StateType &state) {
+        return mix64(static_cast<std::uint64_t>(std::hash<StateType>{}(state)));
+    }
+
+    /// Slot holding a state equal to state, or the free slot where it would go.
+    [[nodiscard]] std::size_t intern_slot(const StateType &state, std::uint64_t hash) const {
+        const std::size_t mask = m_intern_slots.size() - 1;
+        auto slot = static_cast<std::size_t>(hash) & mask;
+        while (m_intern_slots[slot] != 0) {
+            const auto v = m_intern_slots[slot] - 1;
+            if (m_state_hashes[v] == hash && m_states[v] == state) {
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    /// Refills the slots from m_state_hashes at a load of at most 1/2; of
+    /// equal states only the first is indexed.
+    void rebuild_intern_index() {
+        m_intern_slots.assign(std::bit_ceil(std::max<std::size_t>(2 * m_states.size(), 16)), 0);
+        for (std::size_t v = 0; v < m_states.size(); ++v) {
+            auto &entry = m_intern_slots[intern_slot(m_states[v], m_state_hashes[v])];
+            if (entry == 0) {
+                entry = v + 1;
+            }
+        }
+    }
+
+    /// Indexes the state just appended, whose slot intern_slot returned.
+    void intern_last(std::size_t slot, std::uint64_t hash) {
+        m_state_hashes.push_back(hash);
+        if (4 * m_states.size() > 3 * m_intern_slots.size()) {
+            rebuild_intern_index();
+        } else {
+            m_intern_slots[slot] = m_states.size();
+        }
+    }
+
+    void push_label(const LabelType &label) {
+        if constexpr (has_proposition_labels) {
+            m_label_index.resize(label.size());
+            for (std::size_t p = 0; p < label.size(); ++p) {
+                m_label_index[p].push_back(label.test(p));
+            }
+        } else {
+            m_labels.push_back(label);
+        }
+    }
+
+public:
+
+    constexpr KripkeFrame() noexcept = default;
+    constexpr KripkeFrame(const KripkeFrame &) noexcept = default;
+    constexpr KripkeFrame(KripkeFrame &&) noexcept = default;
+    constexpr virtual ~KripkeFrame() noexcept = default;
+
+    constexpr KripkeFrame &operator=(const KripkeFrame &) noexcept = default;
+    constexpr KripkeFrame &operator=(KripkeFrame &&) noexcept = default;
+
+    /// Whether states can be interned: hashable with std::hash and equality comparable.
+    static constexpr bool has_state_hash =
+            std::equality_comparable<StateType> && requires(const StateType &state) {
+                { std::hash<StateType>{}(state) } -> std::convertible_to<std::size_t>;
+            };
+
+    /// Appends a state and returns its index. With interning enabled, a
+    /// state equal to one already in the frame is not added again: the
+    /// existing index is returned and label is ignored.
+    std::size_t add_state(const StateType &state, const LabelType &label) {
+        std::uint64_t hash = 0;
+        std::size_t slot = 0;
+        if constexpr (has_state_hash) {
+            if (is_interning()) {
+                hash = state_hash(state);
+                slot = intern_slot(state, hash);
+                if (m_intern_slots[slot] != 0) {
+                    return m_intern_slots[slot] - 1;
+                }
+            }
+        }
+        m_states.push_back(state);
+        push_label(label);
+        append_successor_list();
+        if constexpr (has_state_hash) {
+            if (is_interning()) {
+                intern_last(slot, hash);
+            }
+        }
+        return m_states.size() - 1;
+    }
+
+    std::size_t add_state(StateType &&state, LabelType &&label) {
+        std::uint64_t hash = 0;
+        std::size_t slot = 0;
+        if constexpr (has_state_hash) {
+            if (is_interning()) {
+                hash = state_hash(state);
+                slot = intern_slot(state, hash);
+                if (m_intern_slots[slot] != 0) {
+                    return m_intern_slots[slot] - 1;
+                }
+            }
+        }
+        m_states.push_back(std::move(state));
+        if constexpr (has_proposition_labels) {
+            push_label(label);
+        } else {
+            m_labels.push_back(std::move(label));
+        }
+        append_successor_list();
+        if constexpr (has_state_hash) {
+            if (is_interning()) {
+                intern_last(slot, hash);
+            }
+        }
+        return m_states.size() - 1;
+    }
+
+    /// Switches add_state to interning, so frames can be built straight from
+    /// an exploration without a separate state -> index map. Indexes the
+    /// states already present; of equal ones, the first keeps its index.
+    /// Changing states through get_state() or the iterators afterwards
+    /// leaves the index stale until enable_interning() is called again.
+    void enable_interning() requires has_state_hash {
+        m_state_hashes.resize(m_states.size());
+        parallel_for(0, m_states.size(), [&](std::size_t v) {
+            m_state_hashes[v] = state_hash(m_states[v]);
+        });
+        rebuild_intern_index();
+    }
+
+    [[nodiscard]] bool is_interning() const noexcept {
+        return !m_intern_slots.empty();
+    }
+
+    /// Memory of the interning index: slots plus cached hashes.
+    [[nodiscard]] std::size_t interning_bytes() const noexcept {
+        return m_intern_slots.size() * sizeof(std::size_t) + m_state_hashes.size() * sizeof(std::uint64_t);
+    }
+
+    /// Index of a state equal to state; always nullopt unless interning.
+    [[nodiscard]] std::optional<std::size_t> find_state(const StateType &state) const requires has_state_hash {
+        if (!is_interning()) {
+            return std::nullopt;
+        }
+        const auto entry = m_intern_slots[intern_slot(state, state_hash(state))];
+        return entry != 0 ? std::optional<std::size_t>(entry - 1) : std::nullopt;
+    }
+
+    /// Adds a transition. On a compacted frame this first expands the
+    /// adjacency back into per-state lists. A current reverse index is
+    /// updated in place rather than rebuilt.
+    void add_transition(std::size_t from, std::size_t to) {
+        expand();
+        m_transitions[from].push_back(to);
+        add_predecessor(from, to);
+    }
+
+    /// Packs the successor lists into one CSR array, which halves the memory
+    /// of sparse frames and makes successor scans contiguous, and folds
+    /// pending reverse-index edits into its CSR. Later edits still work but
+    /// expand the frame again.
+    void compact() {
+        merge_predecessor_overlay();
+        if (is_compact()) {
+            return;
+        }
+        const std::size_t n = m_states.size();
+        std::vector<std::size_t> offsets(n + 1, 0);
+        for (std::size_t v = 0; v < n; ++v) {
+            offsets[v + 1] = offsets[v] + m_transitions[v].size();
+        }
+        m_succ_targets.resize(offsets[n]);
+        parallel_for(0, n, [&](std::size_t v) {
+            std::copy(m_transitions[v].begin(), m_transitions[v].end(),
+                      m_succ_targets.begin() + static_cast<std::ptrdiff_t>(offsets[v]));
+        });
+        m_succ_offsets = std::move(offsets);
+        m_transitions = {};
+    }
+
+    /// Renumbers states so that state v becomes new_index[v], which must be
+    /// a permutation. States, labels and transitions move together, and the
+    /// adjacency keeps its current form (per-state lists or CSR).
+    void permute(std::span<const std::size_t> new_index) {
+        const std::size_t n = m_states.size();
+        std::vector<std::size_t> original(n);
+        for (std::size_t v = 0; v < n; ++v) {
+            original[new_index[v]] = v;
+        }
+        auto gather = [&](auto &values) {
+            std::remove_reference_t<decltype(values)> permuted;
+            permuted.reserve(n);
+            for (std::size_t v = 0; v < n; ++v) {
+                permuted.push_back(std::move(values[original[v]]));
+            }
+            values = std::move(permuted);
+        };
+        gather(m_states);
+        if constexpr (has_state_hash) {
+            if (is_interning()) {
+                gather(m_state_hashes);
+                rebuild_intern_index();
+            }
+        }
+        if constexpr (has_proposition_labels) {
+            for (auto &column: m_label_index) {
+                StateSet permuted(n);
+                column.for_each([&](std::size_t v) { permuted.set(new_index[v]); });
+                column = std::move(permuted);
+            }
+        } else {
+            gather(m_labels);
+        }
+        if (is_compact()) {
+            std::vector<std::size_t> offsets(n + 1, 0);
+            for (std::size_t v = 0; v < n; ++v) {
+                offsets[v + 1] = offsets[v] + successors(original[v]).size();
+            }
+            std::vector<std::size_t> targets(offsets[n]);
+            parallel_for(0, n, [&](std::size_t v) {
+                std::transform(successors(original[v]).begin(), successors(original[v]).end(),
+                               targets.begin() + static_cast<std::ptrdiff_t>(offsets[v]),
+                               [&](std::size_t w) { return new_index[w]; });
+            });
+            m_succ_offsets = std::move(offsets);
+            m_succ_targets = std::move(targets);
+        } else {
+            gather(m_transitions);
+            parallel_for(0, n, [&](std::size_t v) {
+                for (auto &w: m_transitions[v]) {
+                    w = new_index[w];
+                }
+            });
+        }
+        invalidate_predecessors();
+    }
+
+    [[nodiscard]] std::size_t num_states() const {
+        return m_states.size();
+    }
+
+    [[nodiscard]] std::size_t num_transitions() const {
+        if (is_compact()) {
+            return m_succ_targets.size();
+        }
+        std::size_t total = 0;
+        for (const auto &succ: m_transitions) {
+            total += succ.size();
+        }
+        return total;
+    }
+
+    [[nodiscard]] auto successors(std::size_t idx) const -> std::span<const std::size_t> {
+        if (is_compact()) {
+            return {m_succ_targets.data() + m_succ_offsets[idx], m_succ_targets.data() + m_succ_offsets[idx + 1]};
+        }
+        return m_transitions[idx];
+    }
+
+    /// Sources of all transitions into idx, sorted. The reverse index is
+    /// built on the first call, which must therefore not race with other
+    /// readers; call build_predecessor_index() up front before sharing the
+    /// frame between threads. Once built, add_state and add_transition keep
+    /// it current, while permute() drops it.
+    [[nodiscard]] auto predecessors(std::size_t idx) const -> std::span<const std::size_t> {
+        if (!m_pred_valid) {
+            build_predecessor_index();
+        }
+        if (!m_pred_overlay.empty() && !m_pred_overlay[idx].empty()) {
+            return m_pred_overlay[idx];
+        }
+        return {m_pred_sources.data() + m_pred_offsets[idx], m_pred_sources.data() + m_pred_offsets[idx + 1]};
+    }
+
+    /// Builds the reverse CSR with a parallel counting sort over targets.
+    /// Does nothing while the index is current.
+    void build_predecessor_index() const {
+        if (m_pred_valid) {
+            return;
+        }
+        m_pred_overlay = {};
+        const std::size_t n = m_states.size();
+        std::vector<std::atomic<std::size_t>> counts(n);
+        parallel_for(0, n, [&](std::size_t from) {
+            for (auto to: successors(from)) {
+                counts[to].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+
+        m_pred_offsets.assign(n + 1, 0);
+        for (std::size_t v = 0; v < n; ++v) {
+            m_pred_offsets[v + 1] = m_pred_offsets[v] + counts[v].load(std::memory_order_relaxed);
+            counts[v].store(m_pred_offsets[v], std::memory_order_relaxed);
+        }
+
+        m_pred_sources.resize(m_pred_offsets[n]);
+        parallel_for(0, n, [&](std::size_t from) {
+            for (auto to: successors(from)) {
+                m_pred_sources[counts[to].fetch_add(1, std::memory_order_relaxed)] = from;
+            }
+        });
+
+        // Scatter order depends on scheduling; sort each bucket so the index is deterministic.
+        parallel_for(0, n, [&](std::size_t v) {
+            std::sort(m_pred_sources.begin() + static_cast<std::ptrdiff_t>(m_pred_offsets[v]),
+                      m_pred_sources.begin() + static_cast<std::ptrdiff_t>(m_pred_offsets[v + 1]));
+        }, 1024);
+        m_pred_valid = true;
+    }
+
+    constexpr auto get_state(std::size_t idx) const -> const StateType & {
+        return m_states[idx];
+    }
+
+    constexpr auto get_state(std::size_t idx) -> StateType & {
+        return m_states[idx];
+    }
+
+    constexpr auto get_label(std::size_t idx) const -> const LabelType & requires (!has_proposition_labels) {
+        return m_labels[idx];
+    }
+
+    constexpr auto get_label(std::size_t idx) -> LabelType & requires (!has_proposition_labels) {
+        return m_labels[idx];
+    }
+
+    /// Reassembles a proposition label from its columns.
+    auto get_label(std::size_t idx) const -> LabelType requires has_proposition_labels {
+        LabelType label;
+        for (std::size_t p = 0; p < label.size(); ++p) {
+            label.set(p, m_label_index[p].test(idx));
+        }
+        return label;
+    }
+
+    void set_label(std::size_t idx, const LabelType &label) {
+        if constexpr (has_proposition_labels) {
+            for (std::size_t p = 0; p < label.size(); ++p) {
+                m_label_index[p].set(idx, label.test(p));
+            }
+        } else {
+            m_labels[idx] = label;
+        }
+    }
+
+    void set_proposition(std::size_t idx, std::size_t prop, bool value = true) requires has_proposition_labels {
+        m_label_index[prop].set(idx, value);
+    }
+
+    [[nodiscard]] bool holds(std::size_t idx, std::size_t prop) const requires has_proposition_labels {
+        return m_label_index[prop].test(idx);
+    }
+
+    /// All states satisfying atomic proposition prop.
+    [[nodiscard]] auto states_with(std::size_t prop) const -> const StateSet & requires has_proposition_labels {
+        return m_label_index[prop];
+    }
+
+    [[nodiscard]] static constexpr std::size_t num_propositions() noexcept requires has_proposition_labels {
+        return LabelType{}.size();
+    }
+
+    constexpr auto begin() const noexcept -> decltype(m_states.begin()) {
+        return m_states.begin();
+    }
+
+    constexpr auto begin() noexcept -> decltype(m_states.begin()) {
+        return m_states.begin();
+    }
+
+    constexpr auto end() const noexcept -> decltype(m_states.end()) {
+        return m_states.end();
+    }
+
+    constexpr auto end() noexcept -> decltype(m_states.end()) {
+        return m_states.end();
+    }
+
+    constexpr auto cbegin() const noexcept -> decltype(m_states.cbegin()) {
+        return m_states.cbegin();
+    }
+
+};
+
+/// Builds a KripkeFrame from edge lists in bulk. Edges are buffered as packed
+/// (from, to) words, sorted with a parallel radix sort, optionally
+/// deduplicated, and turned directly into the frame's CSR adjacency, so no
+/// per-state successor vectors are ever allocated. Peak memory is about two
+/// words per buffered edge.
+///
+/// State indices must be below max_states; adding an edge with a larger
+/// index fails and leaves the builder unchanged. States referenced by edges but
+/// never added are created on build(), from their index if State can be
+/// constructed from one and value-initialized otherwise.
+template<typename State, typename Label>
+class KripkeFrameBuilder {
+
+public:
+    using FrameType = KripkeFrame<State, Label>;
+
+    static constexpr std::size_t max_states = std::size_t{1} << 32;
+
+private:
+    FrameType m_frame;
+    /// Buffered edges as (from << 32) | to.
+    std::vector<std::size_t> m_edges;
+    std::size_t m_bound = 0;
+
+    static constexpr std::size_t pack(std::size_t from, std::size_t to) noexcept {
+        return from << 32 | to;
+    }
+
+    void note(std::size_t from, std::size_t to) noexcept {
+        m_bound = std::max(m_bound, std::max(from, to) + 1);
+    }
+
+public:
+    [[nodiscard]] std::size_t num_states() const {
+        return std::max(m_frame.num_states(), m_bound);
+    }
+
+    [[nodiscard]] std::size_t num_buffered_edges() const noexcept {
+        return m_edges.size();
+    }
+
+    void reserve_edges(std::size_t count) {
+        m_edges.reserve(count);
+    }
+
+    std::size_t add_state(const State &state, const Label &label) {
+        return m_frame.add_state(state, label);
+    }
+
+    /// Returns false, adding nothing, if an index is not below max_states.
+    bool add_edge(std::size_t from, std::size_t to) {
+        if (from >= max_states || to >= max_states) {
+            return false;
+        }
+        note(from, to);
+        m_edges.push_back(pack(from, to));
+        return true;
+    }
+
+    /// Returns false, adding nothing, if an index is not below max_states.
+    bool add_edges(std::span<const std::pair<std::size_t, std::size_t>> edges) {
+        for (const auto &[from, to]: edges) {
+            if (from >= max_states || to >= max_states) {
+                return false;
+            }
+        }
+        const auto base = m_edges.size();
+        m_edges.resize(base + edges.size());
+        parallel_for(0, edges.size(), [&](std::size_t i) {
+            m_edges[base + i] = pack(edges[i].first, edges[i].second);
+        });
+        for (const auto &[from, to]: edges) {
+            note(from, to);
+        }
+        return true;
+    }
+
+    /// Adds the edges from[i] -> to[i]. Returns false, adding nothing, if
+    /// the spans differ in length or an index is not below max_states.
+    bool add_edges(std::span<const std::size_t> from, std::span<const std::size_t> to) {
+        if (from.size() != to.size()) {
+            return false;
+        }
+        if (from.empty()) {
+            return true;
+        }
+        const auto max_from = *std::max_element(from.begin(), from.end());
+        const auto max_to = *std::max_element(to.begin(), to.end());
+        if (max_from >= max_states || max_to >= max_states) {
+            return false;
+        }
+        const auto base = m_edges.size();
+        m_edges.resize(base + from.size());
+        parallel_for(0, from.size(), [&](std::size_t i) {
+            m_edges[base + i] = pack(from[i], to[i]);
+        });
+        note(max_from, max_to);
+        return true;
+    }
+
+    /// Reads a whitespace-separated "from to" edge list, one edge per line;
+    /// blank lines and lines starting with '#' or '%' are skipped (SNAP and
+    /// Matrix Market style comments). Returns false if the file cannot be
+    /// read or a line does not hold two indices below max_states.
+    bool read_edge_list(const std::filesystem::path &path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return false;
+        }
+        std::vector<char> buffer(std::size_t{1} << 20);
+        std::size_t carry = 0;
+        for (;;) {
+            in.read(buffer.data() + carry, static_cast<std::streamsize>(buffer.size() - carry));
+            const auto end = carry + static_cast<std::size_t>(in.gcount());
+            const bool last = end < buffer.size();
+            const char *cursor = buffer.data();
+            const char *const limit = buffer.data() + end;
+            for (;;) {
+                const auto *eol = static_cast<const char *>(std::memchr(cursor, '\n', static_cast<std::size_t>(limit - cursor)));
+                if (eol == nullptr) {
+                    if (!last) {
+                        break;
+                    }
+                    eol = limit;
+                }
+                const auto *p = cursor;
+                while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r')) {
+                    ++p;
+                }
+                if (p < eol && *p != '#' && *p != '%') {
+                    std::size_t from = 0, to = 0;
+                    auto parsed = std::from_chars(p, eol, from);
+                    if (parsed.ec != std::errc{}) {
+                        return false;
+                    }
+                    p = parsed.ptr;
+                    while (p < eol && (*p == ' ' || *p == '\t')) {
+                        ++p;
+                    }
+                    parsed = std::from_chars(p, eol, to);
+                    if (parsed.ec != std::errc{} || !add_edge(from, to)) {
+                        return false;
+                    }
+                }
+                if (eol == limit) {
+                    break;
+                }
+                cursor = eol + 1;
+            }
+            if (last) {
+                return true;
+            }
+            carry = static_cast<std::size_t>(limit - cursor);
+            if (carry == buffer.size()) {
+                return false;
+            }
+            std::memmove(buffer.data(), cursor, carry);
+        }
+    }
+
+    /// Sorts the buffered edges and hands over the frame. With dedup set,
+    /// repeated edges are dropped; either way successor lists come out sorted.
+    /// Transitions already present in the frame are kept.
+    [[nodiscard]] FrameType build(bool dedup = true) && {
+        for (auto v = m_frame.num_states(); v < m_bound; ++v) {
+            if constexpr (std::is_constructible_v<State, std::size_t>) {
+                m_frame.add_state(State(v), Label{});
+            } else {
+                m_frame.add_state(State{}, Label{});
+            }
+        }
+        const std::size_t n = m_frame.num_states();
+        if (m_frame.num_transitions() != 0) {
+            m_frame.expand();
+            for (std::size_t v = 0; v < n; ++v) {
+                for (auto w: m_frame.successors(v)) {
+                    m_edges.push_back(pack(v, w));
+                }
+            }
+        }
+
+        // Re-pack to the bits actually needed so the sort makes as few passes as possible.
+        const auto bits = static_cast<unsigned>(std::bit_width(n > 0 ? n - 1 : 0));
+        const std::size_t mask = (std::size_t{1} << bits) - 1;
+        parallel_for(0, m_edges.size(), [&](std::size_t i) {
+            m_edges[i] = (m_edges[i] >> 32) << bits | (m_edges[i] & 0xffffffffu);
+        });
+        parallel_radix_sort(m_edges, 2 * bits);
+        if (dedup) {
+            m_edges.erase(std::unique(m_edges.begin(), m_edges.end()), m_edges.end());
+        }
+
+        std::vector<std::size_t> offsets(n + 1, 0);
+        for (auto key: m_edges) {
+            ++offsets[(key >> bits) + 1];
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        parallel_for(0, m_edges.size(), [&](std::size_t i) {
+            m_edges[i] &= mask;
+        });
+        m_edges.shrink_to_fit();
+
+        FrameType frame = std::move(m_frame);
+        frame.m_transitions = {};
+        frame.m_succ_offsets = std::move(offsets);
+        frame.m_succ_targets = std::move(m_edges);
+        frame.invalidate_predecessors();
+        return frame;
+    }
+
+    /// Hands over the frame with adjacency given directly in CSR form: the
+    /// successors of v are targets[offsets[v] .. offsets[v + 1]), and offsets
+    /// has num_states() + 1 entries. For producers that already emit rows in
+    /// state order; no edges may be buffered and the frame must have no
+    /// transitions yet. Debug builds assert that the arrays are consistent.
+    [[nodiscard]] FrameType build_csr(std::vector<std::size_t> offsets, std::vector<std::size_t> targets) && {
+        [[maybe_unused]] const auto n = num_states();
+        assert(m_edges.empty());
+        assert(offsets.size() == n + 1 && offsets.front() == 0 && offsets.back() == targets.size());
+        assert(std::is_sorted(offsets.begin(), offsets.end()));
+        assert(std::all_of(targets.begin(), targets.end(), [n](std::size_t t) { return t < n; }));
+        FrameType frame = std::move(m_frame);
+        frame.m_transitions = {};
+        frame.m_succ_offsets = std::move(offsets);
+        frame.m_succ_targets = std::move(targets);
+        frame.invalidate_predecessors();
+        return frame;
+    }
+};
+
+/// Adjacency lists as frames hand them out: spans for CSR frames, decoding
+/// ranges for compressed ones.
+template<typename R>
+concept StateIndexRange = std::ranges::forward_range<R> && std::ranges::sized_range<R> &&
+                          std::convertible_to<std::ranges::range_value_t<R>, std::size_t>;
+
+/// Read-only frame interface shared by KripkeFrame, MappedKripkeFrame and
+/// CompressedKripkeFrame; analyses that only inspect a frame accept any type
+/// modelling it.
+template<typename F>
+concept KripkeFrameLike = requires(const F &frame, std::size_t idx) {
+    typename F::StateType;
+    typename F::LabelType;
+    { F::has_proposition_labels } -> std::convertible_to<bool>;
+    { frame.num_states() } -> std::convertible_to<std::size_t>;
+    { frame.num_transitions() } -> std::convertible_to<std::size_t>;
+    { frame.successors(idx) } -> StateIndexRange;
+    { frame.predecessors(idx) } -> StateIndexRange;
+    frame.build_predecessor_index();
+    frame.get_state(idx);
+    frame.get_label(idx);
+};
+
+
+/// Fixed header of the binary frame format. Every section starts at a
+/// 64-byte aligned file offset, so a mapped file can be used in place.
+///
+///   header | states | successor offsets | successor targets
+///          | predecessor offsets | predecessor sources | labels
+///
+/// CSR offsets and targets are 64-bit. Proposition labels are stored as one
+/// bitset column per proposition, each padded to 64 bytes; other labels as
+/// a plain array.
+struct FrameFileHeader {
+    static constexpr char expected_magic[8] = {'L', 'A', 'K', 'E', 'K', 'F', 'R', 'M'};
+    static constexpr std::uint32_t current_version = 1;
+    static constexpr std::size_t alignment = 64;
+
+    enum class LabelKind : std::uint32_t {
+        array = 0, propositions = 1
+    };
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t state_size;
+    std::uint64_t num_states;
+    std::uint64_t num_transitions;
+    LabelKind label_kind;
+    /// sizeof(Label) for arrays, the number of propositions for columns.
+    std::uint32_t label_size;
+    std::uint64_t states_offset;
+    std::uint64_t succ_offsets_offset;
+    std::uint64_t succ_targets_offset;
+    std::uint64_t pred_offsets_offset;
+    std::uint64_t pred_sources_offset;
+    std::uint64_t labels_offset;
+    std::uint64_t file_size;
+    std::uint8_t reserved[32];
+
+    static constexpr std::uint64_t align(std::uint64_t offset) noexcept {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    /// Lays out the sections after the header from the counts and sizes
+    /// above. Writer and reader share it, so a reader can reject a header
+    /// whose offsets disagree with its counts.
+    void place_sections() noexcept {
+        const std::uint64_t n = num_states;
+        const std::uint64_t m = num_transitions;
+        const std::uint64_t labels_bytes = label_kind == LabelKind::propositions
+                                           ? label_size * align((n + 63) / 64 * 8)
+                                           : n * label_size;
+        states_offset = align(sizeof(FrameFileHeader));
+        succ_offsets_offset = align(states_offset + n * state_size);
+        succ_targets_offset = align(succ_offsets_offset + (n + 1) * 8);
+        pred_offsets_offset = align(succ_targets_offset + m * 8);
+        pred_sources_offset = align(pred_offsets_offset + (n + 1) * 8);
+        labels_offset = align(pred_sources_offset + m * 8);
+        file_size = align(labels_offset + labels_bytes);
+    }
+};
+
+static_assert(sizeof(FrameFileHeader) == 128);
+static_assert(sizeof(std::size_t) == sizeof(std::uint64_t), "frame files store indices as 64-bit words");
+
+
+template<typename Frame>
+concept StorableKripkeFrame = KripkeFrameLike<Frame> &&
+                              std::is_trivially_copyable_v<typename Frame::StateType> &&
+                              (Frame::has_proposition_labels || std::is_trivially_copyable_v<typename Frame::LabelType>);
+
+/// Writes frame in the binary frame format; returns false on I/O failure.
+template<StorableKripkeFrame Frame>
+bool write_frame_file(const Frame &frame, const std::filesystem::path &path) {
+    using State = typename Frame::StateType;
+    using Label = typename Frame::LabelType;
+    const std::uint64_t n = frame.num_states();
+    const std::uint64_t m = frame.num_transitions();
+
+    FrameFileHeader header{};
+    std::copy(std::begin(FrameFileHeader::expected_magic), std::end(FrameFileHeader::expected_magic), header.magic);
+    header.version = FrameFileHeader::current_version;
+    header.state_size = sizeof(State);
+    header.num_states = n;
+    header.num_transitions = m;
+    const std::uint64_t column_bytes = FrameFileHeader::align((n + 63) / 64 * 8);
+    if constexpr (Frame::has_proposition_labels) {
+        header.label_kind = FrameFileHeader::LabelKind::propositions;
+        header.label_size = static_cast<std::uint32_t>(Label{}.size());
+    } else {
+        header.label_kind = FrameFileHeader::LabelKind::array;
+        header.label_size = sizeof(Label);
+    }
+    header.place_sections();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    auto write = [&](const void *data, std::size_t bytes) {
+        out.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+    };
+    auto pad_to = [&](std::uint64_t offset) {
+        static constexpr char zeros[FrameFileHeader::alignment] = {};
+        const auto at = static_cast<std::uint64_t>(out.tellp());
+        write(zeros, offset - at);
+    };
+    // CSR arrays are written in batches to keep memory bounded on huge frames.
+    auto write_csr = [&](std::uint64_t offsets_at, std::uint64_t targets_at, auto &&adjacent) {
+        pad_to(offsets_at);
+        std::uint64_t total = 0;
+        write(&total, 8);
+        for (std::uint64_t v = 0; v < n; ++v) {
+            total += adjacent(v).size();
+            write(&total, 8);
+        }
+        pad_to(targets_at);
+        std::vector<std::uint64_t> buffer;
+        for (std::uint64_t v = 0; v < n; ++v) {
+            const auto adj = adjacent(v);
+            if constexpr (std::ranges::contiguous_range<decltype(adj)>) {
+                write(adj.data(), adj.size() * 8);
+            } else {
+                buffer.assign(adj.begin(), adj.end());
+                write(buffer.data(), buffer.size() * 8);
+            }
+        }
+    };
+
+    write(&header, sizeof(header));
+    pad_to(header.states_offset);
+    for (std::uint64_t v = 0; v < n; ++v) {
+        write(&frame.get_state(v), sizeof(State));
+    }
+    write_csr(header.succ_offsets_offset, header.succ_targets_offset, [&](auto v) { return frame.successors(v); });
+    frame.build_predecessor_index();
+    write_csr(header.pred_offsets_offset, header.pred_sources_offset, [&](auto v) { return frame.predecessors(v); });
+    pad_to(header.labels_offset);
+    if constexpr (Frame::has_proposition_labels) {
+        for (std::size_t p = 0; p < header.label_size; ++p) {
+            const StateSet column = frame.states_with(p);
+            write(column.words().data(), column.words().size() * 8);
+            pad_to(header.labels_offset + (p + 1) * column_bytes);
+        }
+    } else {
+        for (std::uint64_t v = 0; v < n; ++v) {
+            const Label label = frame.get_label(v);
+            write(&label, sizeof(Label));
+        }
+    }
+    pad_to(header.file_size);
+    return out.good();
+}
+
+
+/// A frame file mapped read-only into memory. Opening only validates the
+/// header and sets up pointers; pages are faulted in as algorithms touch them.
+template<typename State, typename Label>
+class MappedKripkeFrame {
+
+    static_assert(std::is_trivially_copyable_v<State>);
+
+public:
+    using StateType = State;
+    using LabelType = Label;
+
+    static constexpr bool has_proposition_labels = is_proposition_label_v<Label>;
+
+private:
+    const std::byte *m_base = nullptr;
+    std::size_t m_size = 0;
+    const FrameFileHeader *m_header = nullptr;
+
+    MappedKripkeFrame(const std::byte *base, std::size_t size)
+            : m_base(base), m_size(size), m_header(reinterpret_cast<const FrameFileHeader *>(base)) {}
+
+    template<typename T>
+    [[nodiscard]] const T *section(std::uint64_t offset) const noexcept {
+        return reinterpret_cast<const T *>(m_base + offset);
+    }
+
+    [[nodiscard]] auto column(std::size_t prop) const -> std::span<const std::uint64_t> {
+        const auto words = (num_states() + 63) / 64;
+        const auto column_bytes = FrameFileHeader::align(words * 8);
+        return {section<std::uint64_t>(m_header->labels_offset + prop * column_bytes), words};
+    }
+
+public:
+    MappedKripkeFrame(const MappedKripkeFrame &) = delete;
+    MappedKripkeFrame &operator=(const MappedKripkeFrame &) = delete;
+
+    MappedKripkeFrame(MappedKripkeFrame &&other) noexcept
+            : m_base(std::exchange(other.m_base, nullptr)), m_size(other.m_size), m_header(other.m_header) {}
+
+    MappedKripkeFrame &operator=(MappedKripkeFrame &&other) noexcept {
+        std::swap(m_base, other.m_base);
+        std::swap(m_size, other.m_size);
+        std::swap(m_header, other.m_header);
+        return *this;
+    }
+
+    ~MappedKripkeFrame() {
+        if (m_base) {
+            ::munmap(const_cast<std::byte *>(m_base), m_size);
+        }
+    }
+
+    /// Maps path; returns nullopt if it cannot be opened or was not written
+    /// by write_frame_file for this State and Label. Section offsets must
+    /// match the counts in the header and both offset arrays must span
+    /// exactly num_transitions entries; the adjacency itself is not scanned.
+    static std::optional<MappedKripkeFrame> open(const std::filesystem::path &path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return std::nullopt;
+        }
+        struct stat info{};
+        if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(FrameFileHeader)) {
+            ::close(fd);
+            return std::nullopt;
+        }
+        const auto size = static_cast<std::size_t>(info.st_size);
+        void *addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            return std::nullopt;
+        }
+        MappedKripkeFrame frame(static_cast<const std::byte *>(addr), size);
+        const auto &h = *frame.m_header;
+        bool valid = std::equal(std::begin(h.magic), std::end(h.magic), FrameFileHeader::expected_magic) &&
+                     h.version == FrameFileHeader::current_version &&
+                     h.state_size == sizeof(State) &&
+                     h.file_size <= size;
+        if constexpr (has_proposition_labels) {
+            valid = valid && h.label_kind == FrameFileHeader::LabelKind::propositions && h.label_size == num_propositions();
+        } else {
+            valid = valid && h.label_kind == FrameFileHeader::LabelKind::array && h.label_size == sizeof(Label);
+        }
+        // Counts bounded by the file size keep the layout arithmetic exact.
+        valid = valid && h.num_states < size / 8 && h.num_transitions < size / 8;
+        if (valid) {
+            FrameFileHeader expected = h;
+            expected.place_sections();
+            valid = expected.states_offset == h.states_offset &&
+                    expected.succ_offsets_offset == h.succ_offsets_offset &&
+                    expected.succ_targets_offset == h.succ_targets_offset &&
+                    expected.pred_offsets_offset == h.pred_offsets_offset &&
+                    expected.pred_sources_offset == h.pred_sources_offset &&
+                    expected.labels_offset == h.labels_offset &&
+                    expected.file_size == h.file_size;
+        }
+        for (const auto offsets_at: {h.succ_offsets_offset, h.pred_offsets_offset}) {
+            const auto *offsets = frame.template section<std::uint64_t>(offsets_at);
+            valid = valid && offsets[0] == 0 && offsets[h.num_states] == h.num_transitions;
+        }
+        if (!valid) {
+            return std::nullopt;
+        }
+        return frame;
+    }
+
+    [[nodiscard]] std::size_t num_states() const noexcept {
+        return m_header->num_states;
+    }
+
+    [[nodiscard]] std::size_t num_transitions() const noexcept {
+        return m_header->num_transitions;
+    }
+
+    [[nodiscard]] auto successors(std::size_t idx) const -> std::span<const std::size_t> {
+        const auto *offsets = section<std::size_t>(m_header->succ_offsets_offset);
+        return {section<std::size_t>(m_header->succ_targets_offset) + offsets[idx], offsets[idx + 1] - offsets[idx]};
+    }
+
+    [[nodiscard]] auto predecessors(std::size_t idx) const -> std::span<const std::size_t> {
+        const auto *offsets = section<std::size_t>(m_header->pred_offsets_offset);
+        return {section<std::size_t>(m_header->pred_sources_offset) + offsets[idx], offsets[idx + 1] - offsets[idx]};
+    }
+
+    /// The predecessor index is part of the file.
+    void build_predecessor_index() const noexcept {}
+
+    [[nodiscard]] auto get_state(std::size_t idx) const -> const StateType & {
+        return section<StateType>(m_header->states_offset)[idx];
+    }
+
+    [[nodiscard]] auto get_label(std::size_t idx) const -> const LabelType & requires (!has_proposition_labels) {
+        return section<LabelType>(m_header->labels_offset)[idx];
+    }
+
+    [[nodiscard]] auto get_label(std::size_t idx) const -> LabelType requires has_proposition_labels {
+        LabelType label;
+        for (std::size_t p = 0; p < label.size(); ++p) {
+            label.set(p, holds(idx, p));
+        }
+        return label;
+    }
+
+    [[nodiscard]] bool holds(std::size_t idx, std::size_t prop) const requires has_proposition_labels {
+        return (column(prop)[idx / 64] >> (idx % 64)) & 1u;
+    }
+
+    /// Copies the proposition column out of the mapping.
+    [[nodiscard]] StateSet states_with(std::size_t prop) const requires has_proposition_labels {
+        return StateSet(column(prop), num_states());
+    }
+
+    [[nodiscard]] static constexpr std::size_t num_propositions() noexcept requires has_proposition_labels {
+        return LabelType{}.size();
+    }
+
+    [[nodiscard]] auto states() const -> std::span<const StateType> {
+        return {section<StateType>(m_header->states_offset), num_states()};
+    }
+
+    [[nodiscard]] auto begin() const noexcept {
+        return states().begin();
+    }
+
+    [[nodiscard]] auto end() const noexcept {
+        return states().end();
+    }
+};
+
+/// A renumbering that lists states in BFS order from state 0, restarting from
+/// the lowest unvisited state, so states that are close in the graph get
+/// close indices. Returns the new index of every state.
+template<KripkeFrameLike Frame>
+std::vector<std::size_t> bfs_order(const Frame &frame) {
+    const std::size_t n = frame.num_states();
+    std::vector<std::size_t> order(n, StateSet::npos);
+    std::vector<std::size_t> queue;
+    queue.reserve(n);
+    std::size_t next = 0;
+    for (std::size_t root = 0; root < n; ++root) {
+        if (order[root] != StateSet::npos) {
+            continue;
+        }
+        order[root] = next++;
+        queue.push_back(root);
+        for (std::size_t head = queue.size() - 1; head < queue.size(); ++head) {
+            for (auto w: frame.successors(queue[head])) {
+                if (order[w] == StateSet::npos) {
+                    order[w] = next++;
+                    queue.push_back(w);
+                }
+            }
+        }
+    }
+    return order;
+}
+
+
+/// Reverse Cuthill–McKee on the undirected version of the frame: BFS from a
+/// lowest-degree state of every component, visiting neighbours by
+/// increasing degree, then reversed. Keeps transitions close to the
+/// diagonal, so both directions of a traversal touch nearby states.
+template<KripkeFrameLike Frame>
+std::vector<std::size_t> reverse_cuthill_mckee_order(const Frame &frame) {
+    const std::size_t n = frame.num_states();
+    frame.build_predecessor_index();
+    std::vector<std::size_t> degree(n);
+    for (std::size_t v = 0; v < n; ++v) {
+        degree[v] = frame.successors(v).size() + frame.predecessors(v).size();
+    }
+    const auto by_degree = [&](std::size_t a, std::size_t b) { return degree[a] < degree[b]; };
+    std::vector<std::size_t> roots(n);
+    std::iota(roots.begin(), roots.end(), 0);
+    std::stable_sort(roots.begin(), roots.end(), by_degree);
+
+    std::vector<char> placed(n, 0);
+    std::vector<std::size_t> sequence, neighbours;
+    sequence.reserve(n);
+    for (auto root: roots) {
+        if (placed[root]) {
+            continue;
+        }
+        placed[root] = 1;
+        sequence.push_back(root);
+        for (std::size_t head = sequence.size() - 1; head < sequence.size(); ++head) {
+            const auto v = sequence[head];
+            neighbours.clear();
+            const auto visit = [&](std::size_t w) {
+                if (!placed[w]) {
+                    placed[w] = 1;
+                    neighbours.push_back(w);
+                }
+            };
+            std::ranges::for_each(frame.successors(v), visit);
+            std::ranges::for_each(frame.predecessors(v), visit);
+            std::stable_sort(neighbours.begin(), neighbours.end(), by_degree);
+            sequence.insert(sequence.end(), neighbours.begin(), neighbours.end());
+        }
+    }
+    std::vector<std::size_t> order(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        order[sequence[n - 1 - i]] = i;
+    }
+    return order;
+}
+
+/// Gorder-style greedy ordering (Wei et al.): repeatedly places the state
+/// with the highest score against the last `window` placed states, scoring
+/// one point per transition to or from a window state and per in-neighbour
+/// shared with one. Scores only move by one, so candidates sit in score
+/// buckets and the best is found in constant time. In-neighbours with more
+/// than sqrt(n) successors are not used for sharing, as in the paper.
+template<KripkeFrameLike Frame>
+std::vector<std::size_t> gorder_order(const Frame &frame, std::size_t window = 5) {
+    constexpr auto none = StateSet::npos;
+    const std::size_t n = frame.num_states();
+    frame.build_predecessor_index();
+    const auto hub = std::max<std::size_t>(16, static_cast<std::size_t>(std::sqrt(static_cast<double>(n))));
+
+    std::vector<std::size_t> score(n, 0), prev(n, none), next(n, none);
+    std::vector<std::size_t> bucket_head{none};
+    std::vector<char> placed(n, 0);
+    std::size_t top = 0;
+    const auto unlink = [&](std::size_t v) {
+        (prev[v] == none ? bucket_head[score[v]] : next[prev[v]]) = next[v];
+        if (next[v] != none) {
+            prev[next[v]] = prev[v];
+        }
+    };
+    const auto link = [&](std::size_t v) {
+        if (score[v] == bucket_head.size()) {
+            bucket_head.push_back(none);
+        }
+        prev[v] = none;
+        next[v] = bucket_head[score[v]];
+        if (next[v] != none) {
+            prev[next[v]] = v;
+        }
+        bucket_head[score[v]] = v;
+        top = std::max(top, score[v]);
+    };
+    const auto adjust = [&](std::size_t v, bool up) {
+        if (placed[v]) {
+            return;
+        }
+        unlink(v);
+        score[v] = up ? score[v] + 1 : score[v] - 1;
+        link(v);
+    };
+    // Scores of the states related to v, raised as v enters the window and lowered as it leaves.
+    const auto update = [&](std::size_t v, bool up) {
+        for (auto w: frame.successors(v)) {
+            adjust(w, up);
+        }
+        for (auto x: frame.predecessors(v)) {
+            adjust(x, up);
+            if (frame.successors(x).size() <= hub) {
+                for (auto w: frame.successors(x)) {
+                    adjust(w, up);
+                }
+            }
+        }
+    };
+
+    for (std::size_t v = n; v-- > 0;) {
+        link(v);
+    }
+    std::vector<std::size_t> sequence;
+    sequence.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        while (bucket_head[top] == none) {
+            --top;
+        }
+        const auto v = bucket_head[top];
+        unlink(v);
+        placed[v] = 1;
+        sequence.push_back(v);
+        update(v, true);
+        if (i >= window) {
+            update(sequence[i - window], false);
+        }
+    }
+    std::vector<std::size_t> order(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        order[sequence[i]] = i;
+    }
+    return order;
+}
+
+enum class StateOrder {
+    bfs, reverse_cuthill_mckee, gorder
+};
+
+template<KripkeFrameLike Frame>
+std::vector<std::size_t> state_order(const Frame &frame, StateOrder kind) {
+    switch (kind) {
+        case StateOrder::bfs:
+            return bfs_order(frame);
+        case StateOrder::reverse_cuthill_mckee:
+            return reverse_cuthill_mckee_order(frame);
+        case StateOrder::gorder:
+            return gorder_order(frame);
+    }
+    return {};
+}
+
+/// Renumbers frame for locality and returns the new index of every state.
+template<typename State, typename Label>
+std::vector<std::size_t> reorder(KripkeFrame<State, Label> &frame, StateOrder kind = StateOrder::reverse_cuthill_mckee) {
+    auto order = state_order(frame, kind);
+    frame.permute(order);
+    return order;
+}
+
+/// Forward range over one gap-encoded adjacency list (see
+/// CompressedKripkeFrame). Decoding a gap is one unaligned 64-bit load, a
+/// shift and a mask, without branches on the encoded data.
+class PackedAdjacency {
+
+private:
+    const std::uint8_t *m_bits = nullptr;
+    std::size_t m_first = 0;
+    std::size_t m_size = 0;
+    unsigned m_width = 0;
+
+public:
+    class iterator {
+
+    private:
+        const std::uint8_t *m_bits = nullptr;
+        std::size_t m_bit = 0;
+        std::size_t m_remaining = 0;
+        std::size_t m_value = 0;
+        unsigned m_width = 0;
+
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        iterator(const std::uint8_t *bits, unsigned width, std::size_t first, std::size_t remaining) noexcept
+                : m_bits(bits), m_remaining(remaining), m_value(first), m_width(width) {}
+
+        std::size_t operator*() const noexcept {
+            return m_value;
+        }
+
+        iterator &operator++() noexcept {
+            std::uint64_t word;
+            std::memcpy(&word, m_bits + (m_bit >> 3), sizeof(word));
+            m_value += (word >> (m_bit & 7)) & ((std::uint64_t{1} << m_width) - 1);
+            m_bit += m_width;
+            --m_remaining;
+            return *this;
+        }
+
+        iterator operator++(int) noexcept {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+
+        friend bool operator==(const iterator &a, const iterator &b) noexcept {
+            return a.m_remaining == b.m_remaining;
+        }
+    };
+
+    PackedAdjacency() = default;
+
+    PackedAdjacency(const std::uint8_t *bits, unsigned width, std::size_t first, std::size_t size) noexcept
+            : m_bits(bits), m_first(first), m_size(size), m_width(width) {}
+
+    [[nodiscard]] iterator begin() const noexcept {
+        return {m_bits, m_width, m_first, m_size};
+    }
+
+    [[nodiscard]] iterator end() const noexcept {
+        return {};
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_size == 0;
+    }
+};
+
+
+/// Read-only frame with gap-encoded adjacency, for frames whose CSR target
+/// arrays no longer fit comfortably in memory. Every list is sorted and
+/// stored as
+///
+///   varint degree | varint zigzag(first - source) | width byte | gaps
+///
+/// with the degree - 1 gaps bit-packed at a common width. Local edges and
+/// renumbered states give small gaps, so lists shrink to a few bits per
+/// edge. The predecessor index is encoded the same way on demand. Gaps are
+/// read as single words, which limits frames to 2^56 states.
+///
+/// A renumbering (new index of every original state, e.g. from bfs_order)
+/// can be applied while compressing to improve gap sizes and locality.
+template<typename State, typename Label>
+class CompressedKripkeFrame {
+
+public:
+    using StateType = State;
+    using LabelType = Label;
+
+    static constexpr bool has_proposition_labels = is_proposition_label_v<Label>;
+
+private:
+    /// Byte offset of every list, and the encoded lists with eight bytes of
+    /// padding so the decoder may always load a full word.
+    struct Lists {
+        std::vector<std::size_t> offsets;
+        std::vector<std::uint8_t> bytes;
+    };
+
+    std::vector<StateType> m_states;
+    std::vector<LabelType> m_labels;
+    std::vector<StateSet> m_label_index;
+    std::vector<std::size_t> m_renumbering;
+    std::size_t m_num_transitions = 0;
+    Lists m_successors;
+    mutable Lists m_predecessors;
+    mutable bool m_pred_valid = false;
+
+    static std::size_t varint_size(std::uint64_t value) noexcept {
+        return std::max<std::size_t>(1, (std::bit_width(value) + 6) / 7);
+    }
+
+    static std::uint8_t *put_varint(std::uint8_t *out, std::uint64_t value) noexcept {
+        while (value >= 0x80) {
+            *out++ = static_cast<std::uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        *out++ = static_cast<std::uint8_t>(value);
+        return out;
+    }
+
+    static const std::uint8_t *get_varint(const std::uint8_t *in, std::uint64_t &value) noexcept {
+        value = 0;
+        for (unsigned shift = 0;; shift += 7) {
+            const auto byte = *in++;
+            value |= std::uint64_t{byte & 0x7fu} << shift;
+            if (byte < 0x80) {
+                return in;
+            }
+        }
+    }
+
+    static std::uint64_t zigzag(std::size_t to, std::size_t from) noexcept {
+        const auto delta = static_cast<std::int64_t>(to - from);
+        return (static_cast<std::uint64_t>(delta) << 1) ^ static_cast<std::uint64_t>(delta >> 63);
+    }
+
+    static unsigned gap_width(std::span<const std::size_t> sorted) noexcept {
+        std::size_t widest = 0;
+        for (std::size_t i = 1; i < sorted.size(); ++i) {
+            widest = std::max(widest, sorted[i] - sorted[i - 1]);
+        }
+        return static_cast<unsigned>(std::bit_width(widest));
+    }
+
+    static std::size_t encoded_size(std::size_t source, std::span<const std::size_t> sorted) noexcept {
+        if (sorted.empty()) {
+            return 1;
+        }
+        std::size_t bytes = varint_size(sorted.size()) + varint_size(zigzag(sorted[0], source));
+        if (sorted.size() > 1) {
+            bytes += 1 + ((sorted.size() - 1) * gap_width(sorted) + 7) / 8;
+        }
+        return bytes;
+    }
+
+    static void encode(std::uint8_t *out, std::size_t source, std::span<const std::size_t> sorted) noexcept {
+        out = put_varint(out, sorted.size());
+        if (sorted.empty()) {
+            return;
+        }
+        out = put_varint(out, zigzag(sorted[0], source));
+        if (sorted.size() == 1) {
+            return;
+        }
+        const auto width = gap_width(sorted);
+        *out++ = static_cast<std::uint8_t>(width);
+        std::size_t bit = 0;
+        for (std::size_t i = 1; i < sorted.size(); ++i, bit += width) {
+            const std::uint64_t gap = sorted[i] - sorted[i - 1];
+            for (unsigned b = 0; b < width; b += 8 - static_cast<unsigned>((bit + b) & 7)) {
+                out[(bit + b) >> 3] |= static_cast<std::uint8_t>((gap >> b) << ((bit + b) & 7));
+            }
+        }
+    }
+
+    /// Encodes n lists in parallel: sizes first, then every list into its slot.
+    template<typename Adjacent>
+    static Lists encode_all(std::size_t n, Adjacent &&adjacent) {
+        Lists lists;
+        lists.offsets.assign(n + 1, 0);
+        parallel_for(0, n, [&](std::size_t v) {
+            thread_local std::vector<std::size_t> sorted;
+            adjacent(v, sorted);
+            lists.offsets[v + 1] = encoded_size(v, sorted);
+        }, 1024);
+        std::partial_sum(lists.offsets.begin(), lists.offsets.end(), lists.offsets.begin());
+        lists.bytes.assign(lists.offsets[n] + sizeof(std::uint64_t), 0);
+        parallel_for(0, n, [&](std::size_t v) {
+            thread_local std::vector<std::size_t> sorted;
+            adjacent(v, sorted);
+            encode(lists.bytes.data() + lists.offsets[v], v, sorted);
+        }, 1024);
+        return lists;
+    }
+
+    static PackedAdjacency decode(const Lists &lists, std::size_t v) noexcept {
+        const auto *in = lists.bytes.data() + lists.offsets[v];
+        std::uint64_t degree;
+        in = get_varint(in, degree);
+        if (degree == 0) {
+            return {};
+        }
+        std::uint64_t first;
+        in = get_varint(in, first);
+        const auto delta = static_cast<std::int64_t>(first >> 1) ^ -static_cast<std::int64_t>(first & 1);
+        const auto target = v + static_cast<std::size_t>(delta);
+        if (degree == 1) {
+            return {in, 0, target, 1};
+        }
+        return {in + 1, *in, target, degree};
+    }
+
+public:
+    /// Compresses frame. renumbering, if not empty, gives the new index of
+    /// every state and must be a permutation.
+    template<KripkeFrameLike Frame>
+    requires std::same_as<typename Frame::StateType, State> && std::same_as<typename Frame::LabelType, Label>
+    explicit CompressedKripkeFrame(const Frame &frame, std::vector<std::size_t> renumbering = {})
+            : m_renumbering(std::move(renumbering)), m_num_transitions(frame.num_transitions()) {
+        const std::size_t n = frame.num_states();
+        std::vector<std::size_t> original(n);
+        std::iota(original.begin(), original.end(), 0);
+        if (!m_renumbering.empty()) {
+            for (std::size_t v = 0; v < n; ++v) {
+                original[m_renumbering[v]] = v;
+            }
+        }
+        const auto renumber = [&](std::size_t v) {
+            return m_renumbering.empty() ? v : m_renumbering[v];
+        };
+
+        m_states.reserve(n);
+        for (std::size_t v = 0; v < n; ++v) {
+            m_states.push_back(frame.get_state(original[v]));
+        }
+        if constexpr (has_proposition_labels) {
+            m_label_index.assign(num_propositions(), StateSet(n));
+            for (std::size_t v = 0; v < n; ++v) {
+                const LabelType label = frame.get_label(original[v]);
+                for (std::size_t p = 0; p < label.size(); ++p) {
+                    m_label_index[p].set(v, label.test(p));
+                }
+            }
+        } else {
+            m_labels.reserve(n);
+            for (std::size_t v = 0; v < n; ++v) {
+                m_labels.push_back(frame.get_label(original[v]));
+            }
+        }
+        m_successors = encode_all(n, [&](std::size_t v, std::vector<std::size_t> &out) {
+            out.clear();
+            for (auto w: frame.successors(original[v])) {
+                out.push_back(renumber(w));
+            }
+            std::sort(out.begin(), out.end());
+        });
+    }
+
+    [[nodiscard]] std::size_t num_states() const noexcept {
+        return m_states.size();
+    }
+
+    [[nodiscard]] std::size_t num_transitions() const noexcept {
+        return m_num_transitions;
+    }
+
+    /// Successors of idx in ascending order.
+    [[nodiscard]] PackedAdjacency successors(std::size_t idx) const noexcept {
+        return decode(m_successors, idx);
+    }
+
+    /// Sources of all transitions into idx in ascending order. Builds the
+    /// encoded reverse index on first use, so call build_predecessor_index()
+    /// before sharing the frame between threads.
+    [[nodiscard]] PackedAdjacency predecessors(std::size_t idx) const {
+        if (!m_pred_valid) {
+            build_predecessor_index();
+        }
+        return decode(m_predecessors, idx);
+    }
+
+    void build_predecessor_index() const {
+        if (m_pred_valid) {
+            return;
+        }
+        const std::size_t n = num_states();
+        std::vector<std::size_t> offsets(n + 1, 0);
+        for (std::size_t v = 0; v < n; ++v) {
+            for (auto w: successors(v)) {
+                ++offsets[w + 1];
+            }
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<std::size_t> sources(offsets[n]);
+        {
+            auto next = offsets;
+            // Sources are visited in ascending order, so every bucket ends up sorted.
+            for (std::size_t v = 0; v < n; ++v) {
+                for (auto w: successors(v)) {
+                    sources[next[w]++] = v;
+                }
+            }
+        }
+        m_predecessors = encode_all(n, [&](std::size_t v, std::vector<std::size_t> &out) {
+            out.assign(sources.begin() + static_cast<std::ptrdiff_t>(offsets[v]),
+                       sources.begin() + static_cast<std::ptrdiff_t>(offsets[v + 1]));
+        });
+        m_pred_valid = true;
+    }
+
+    /// New index of every original state; empty if states were not renumbered.
+    [[nodiscard]] auto renumbering() const noexcept -> std::span<const std::size_t> {
+        return m_renumbering;
+    }
+
+    /// Bytes used by the encoded successor lists and their offsets.
+    [[nodiscard]] std::size_t adjacency_bytes() const noexcept {
+        return m_successors.bytes.size() + m_successors.offsets.size() * sizeof(std::size_t);
+    }
+
+    [[nodiscard]] auto get_state(std::size_t idx) const -> const StateType & {
+        return m_states[idx];
+    }
+
+    [[nodiscard]] auto get_label(std::size_t idx) const -> const LabelType & requires (!has_proposition_labels) {
+        return m_labels[idx];
+    }
+
+    [[nodiscard]] auto get_label(std::size_t idx) const -> LabelType requires has_proposition_labels {
+        LabelType label;
+        for (std::size_t p = 0; p < label.size(); ++p) {
+            label.set(p, m_label_index[p].test(idx));
+        }
+        return label;
+    }
+
+    [[nodiscard]] bool holds(std::size_t idx, std::size_t prop) const requires has_proposition_labels {
+        return m_label_index[prop].test(idx);
+    }
+
+    [[nodiscard]] auto states_with(std::size_t prop) const -> const StateSet & requires has_proposition_labels {
+        return m_label_index[prop];
+    }
+
+    [[nodiscard]] static constexpr std::size_t num_propositions() noexcept requires has_proposition_labels {
+        return LabelType{}.size();
+    }
+
+    [[nodiscard]] auto begin() const noexcept {
+        return m_states.begin();
+    }
+
+    [[nodiscard]] auto end() const noexcept {
+        return m_states.end();
+    }
+};
+
+class Bdd;
+
+/// Reduced ordered BDD package: a hash-consed node store with a unique table,
+/// a direct-mapped computed cache, mark-and-sweep garbage collection rooted at
+/// the live Bdd handles, and dynamic variable reordering by sifting.
+class BddManager {
+
+public:
+    using Node = std::uint32_t;
+
+    static constexpr Node zero = 0;
+    static constexpr Node one = 1;
+
+private:
+    static constexpr Node nil = static_cast<Node>(-1);
+    static constexpr std::uint32_t terminal_var = static_cast<std::uint32_t>(-1);
+    static constexpr std::uint32_t free_var = static_cast<std::uint32_t>(-2);
+
+    struct NodeData {
+        std::uint32_t var;
+        Node low;
+        Node high;
+        Node next;
+    };
+
+    enum class Op : std::uint32_t {
+        none, ite, exists, and_exists, rename
+    };
+
+    struct CacheEntry {
+        Op op = Op::none;
+        Node a = 0;
+        Node b = 0;
+        Node c = 0;
+        Node result = 0;
+    };
+
+    std::vector<NodeData> m_nodes;
+    std::vector<std::uint32_t> m_ext_refs;
+    std::vector<Node> m_buckets;
+    Node m_free = nil;
+    std::size_t m_free_count = 0;
+
+    std::vector<std::uint32_t> m_var2level;
+    std::vector<std::uint32_t> m_level2var;
+
+    std::vector<CacheEntry> m_cache;
+
+    /// Variable permutations registered for rename(), indexed by id.
+    std::vector<std::vector<std::uint32_t>> m_perms;
+
+    std::size_t m_gc_threshold = 1 << 16;
+    bool m_auto_reorder = false;
+    std::size_t m_reorder_threshold = 1 << 14;
+
+    static std::size_t hash3(std::uint64_t a, std::uint64_t b, std::uint64_t c) {
+        std::uint64_t h = a * 0x9E3779B97F4A7C15ull;
+        h ^= b + 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2);
+        h ^= c + 0x165667B19E3779F9ull + (h << 6) + (h >> 2);
+        return static_cast<std::size_t>(h ^ (h >> 31));
+    }
+
+    [[nodiscard]] std::uint32_t level(Node n) const {
+        const auto var = m_nodes[n].var;
+        return var == terminal_var ? static_cast<std::uint32_t>(m_level2var.size()) : m_var2level[var];
+    }
+
+    [[nodiscard]] std::size_t bucket_of(std::uint32_t var, Node low, Node high) const {
+        return hash3(var, low, high) & (m_buckets.size() - 1);
+    }
+
+    void unique_insert(Node n) {
+        auto &head = m_buckets[bucket_of(m_nodes[n].var, m_nodes[n].low, m_nodes[n].high)];
+        m_nodes[n].next = head;
+        head = n;
+    }
+
+    void unique_erase(Node n) {
+        Node *link = &m_buckets[bucket_of(m_nodes[n].var, m_nodes[n].low, m_nodes[n].high)];
+        while (*link != n) {
+            link = &m_nodes[*link].next;
+        }
+        *link = m_nodes[n].next;
+    }
+
+    void rehash(std::size_t buckets) {
+        m_buckets.assign(buckets, nil);
+        for (Node n = 2; n < m_nodes.size(); ++n) {
+            if (m_nodes[n].var != free_var) {
+                unique_insert(n);
+            }
+        }
+    }
+
+    /// Finds or creates the node (var, low, high). Never collects garbage, so
+    /// intermediate results of a running operation stay valid.
+    Node mk(std::uint32_t var, Node low, Node high) {
+        if (low == high) {
+            return low;
+        }
+        for (Node n = m_buckets[bucket_of(var, low, high)]; n != nil; n = m_nodes[n].next) {
+            if (m_nodes[n].var == var && m_nodes[n].low == low && m_nodes[n].high == high) {
+                return n;
+            }
+        }
+        Node n;
+        if (m_free != nil) {
+            n = m_free;
+            m_free = m_nodes[n].next;
+            --m_free_count;
+            m_nodes[n] = {var, low, high, nil};
+        } else {
+            n = static_cast<Node>(m_nodes.size());
+            m_nodes.push_back({var, low, high, nil});
+            m_ext_refs.push_back(0);
+            if (m_nodes.size() > 2 * m_buckets.size()) {
+                rehash(2 * m_buckets.size());
+                return n;
+            }
+        }
+        unique_insert(n);
+        return n;
+    }
+
+    [[nodiscard]] CacheEntry &cache_slot(Op op, Node a, Node b, Node c) {
+        return m_cache[hash3((static_cast<std::uint64_t>(op) << 32) | a, b, c) & (m_cache.size() - 1)];
+    }
+
+    bool cache_lookup(Op op, Node a, Node b, Node c, Node &result) {
+        const auto &entry = cache_slot(op, a, b, c);
+        if (entry.op == op && entry.a == a && entry.b == b && entry.c == c) {
+            result = entry.result;
+            return true;
+        }
+        return false;
+    }
+
+    void cache_store(Op op, Node a, Node b, Node c, Node result) {
+        cache_slot(op, a, b, c) = {op, a, b, c, result};
+    }
+
+    Node ite_rec(Node f, Node g, Node h) {
+        if (f == one) {
+            return g;
+        }
+        if (f == zero) {
+            return h;
+        }
+        if (g == h) {
+            return g;
+        }
+        if (g == one && h == zero) {
+            return f;
+        }
+        Node result;
+        if (cache_lookup(Op::ite, f, g, h, result)) {
+            return result;
+        }
+        const auto top = std::min({level(f), level(g), level(h)});
+        const auto var = m_level2var[top];
+        auto cofactor = [&](Node n, bool branch) {
+            return level(n) == top ? (branch ? m_nodes[n].high : m_nodes[n].low) : n;
+        };
+        const Node low = ite_rec(cofactor(f, false), cofactor(g, false), cofactor(h, false));
+        const Node high = ite_rec(cofactor(f, true), cofactor(g, true), cofactor(h, true));
+        result = mk(var, low, high);
+        cache_store(Op::ite, f, g, h, result);
+        return result;
+    }
+
+    Node exists_rec(Node f, Node cube) {
+        if (f <= one) {
+            return f;
+        }
+        while (cube != one && level(cube) < level(f)) {
+            cube = m_nodes[cube].high;
+        }
+        if (cube == one) {
+            return f;
+        }
+        Node result;
+        if (cache_lookup(Op::exists, f, cube, 0, result)) {
+            return result;
+        }
+        const Node low = exists_rec(m_nodes[f].low, cube);
+        const Node high = exists_rec(m_nodes[f].high, cube);
+        if (level(cube) == level(f)) {
+            result = ite_rec(low, one, high);
+        } else {
+            result = mk(m_nodes[f].var, low, high);
+        }
+        cache_store(Op::exists, f, cube, 0, result);
+        return result;
+    }
+
+    /// Relational product: exists cube. f & g without building f & g.
+    Node and_exists_rec(Node f, Node g, Node cube) {
+        if (f == zero || g == zero) {
+            return zero;
+        }
+        if (f == one && g == one) {
+            return one;
+        }
+        if (f == one) {
+            return exists_rec(g, cube);
+        }
+        if (g == one || f == g) {
+            return exists_rec(f, cube);
+        }
+        const auto top = std::min(level(f), level(g));
+        while (cube != one && level(cube) < top) {
+            cube = m_nodes[cube].high;
+        }
+        if (cube == one) {
+            return ite_rec(f, g, zero);
+        }
+        if (f > g) {
+            std::swap(f, g);
+        }
+        Node result;
+        if (cache_lookup(Op::and_exists, f, g, cube, result)) {
+            return result;
+        }
+        auto cofactor = [&](Node n, bool branch) {
+            return level(n) == top ? (branch ? m_nodes[n].high : m_nodes[n].low) : n;
+        };
+        if (level(cube) == top) {
+            const Node rest = m_nodes[cube].high;
+            const Node low = and_exists_rec(cofactor(f, false), cofactor(g, false), rest);
+            if (low == one) {
+                result = one;
+            } else {
+                const Node high = and_exists_rec(cofactor(f, true), cofactor(g, true), rest);
+                result = ite_rec(low, one, high);
+            }
+        } else {
+            const Node low = and_exists_rec(cofactor(f, false), cofactor(g, false), cube);
+            const Node high = and_exists_rec(cofactor(f, true), cofactor(g, true), cube);
+            result = mk(m_level2var[top], low, high);
+        }
+        cache_store(Op::and_exists, f, g, cube, result);
+        return result;
+    }
+
+    Node rename_rec(Node f, std::uint32_t perm) {
+        if (f <= one) {
+            return f;
+        }
+        Node result;
+        if (cache_lookup(Op::rename, f, perm, 0, result)) {
+            return result;
+        }
+        const Node low = rename_rec(m_nodes[f].low, perm);
+        const Node high = rename_rec(m_nodes[f].high, perm);
+        result = ite_rec(mk(m_perms[perm][m_nodes[f].var], zero, one), high, low);
+        cache_store(Op::rename, f, perm, 0, result);
+        return result;
+    }
+
+    /// Called on entry to every public operation, when all live nodes are
+    /// reachable from handles.
+    void maybe_collect() {
+        const auto live = num_nodes();
+        if (m_auto_reorder && live > m_reorder_threshold) {
+            reorder_sift();
+            m_reorder_threshold = std::max(m_reorder_threshold, 2 * num_nodes());
+        } else if (live > m_gc_threshold) {
+            gc();
+            m_gc_threshold = std::max(m_gc_threshold, 2 * num_nodes());
+        }
+    }
+
+    /// Bookkeeping for sifting, which swaps levels without collecting
+    /// garbage in between. refs counts parents plus handles for every node;
+    /// a node whose count drops to zero is unlinked at once, but its slot
+    /// stays off the free list until sifting ends, so nodes[var] can be
+    /// filtered by comparing each entry's variable.
+    struct SiftState {
+        std::vector<std::uint32_t> refs;
+        std::vector<std::vector<Node>> nodes;
+        std::size_t live = 0;
+    };
+
+    /// mk that keeps the sift state's counts and node lists current.
+    Node sift_mk(SiftState &state, std::uint32_t var, Node low, Node high) {
+        const auto before = num_nodes();
+        const Node n = mk(var, low, high);
+        if (num_nodes() != before) {
+            state.refs.resize(m_nodes.size(), 0);
+            ++state.refs[low];
+            ++state.refs[high];
+            state.nodes[var].push_back(n);
+            ++state.live;
+        }
+        ++state.refs[n];
+        return n;
+    }
+
+    /// Drops one reference to n, unlinking it and everything only it kept
+    /// alive once the count reaches zero.
+    void sift_release(SiftState &state, Node n) {
+        std::vector<Node> stack{n};
+        while (!stack.empty()) {
+            const Node dead = stack.back();
+            stack.pop_back();
+            if (dead <= one || --state.refs[dead] != 0) {
+                continue;
+            }
+            unique_erase(dead);
+            stack.push_back(m_nodes[dead].low);
+            stack.push_back(m_nodes[dead].high);
+            m_nodes[dead].var = free_var;
+            --state.live;
+        }
+    }
+
+    /// Exchanges the variables at levels lvl and lvl + 1, rewriting the upper
+    /// level's nodes in place so that every existing node keeps its function.
+    /// Only the two levels' node lists are visited; lower-level nodes that
+    /// lose their last parent are released on the spot.
+    void swap_levels(SiftState &state, std::uint32_t lvl) {
+        const auto x = m_level2var[lvl];
+        const auto y = m_level2var[lvl + 1];
+        std::vector<Node> rewrite;
+        for (auto n: state.nodes[x]) {
+            if (m_nodes[n].var == x && (m_nodes[m_nodes[n].low].var == y || m_nodes[m_nodes[n].high].var == y)) {
+                rewrite.push_back(n);
+            }
+        }
+        std::swap(m_level2var[lvl], m_level2var[lvl + 1]);
+        m_var2level[x] = lvl + 1;
+        m_var2level[y] = lvl;
+        for (auto n: rewrite) {
+            const Node f0 = m_nodes[n].low;
+            const Node f1 = m_nodes[n].high;
+            const Node f00 = m_nodes[f0].var == y ? m_nodes[f0].low : f0;
+            const Node f01 = m_nodes[f0].var == y ? m_nodes[f0].high : f0;
+            const Node f10 = m_nodes[f1].var == y ? m_nodes[f1].low : f1;
+            const Node f11 = m_nodes[f1].var == y ? m_nodes[f1].high : f1;
+            // mk may rehash, so n keeps its old key until the new children exist.
+            const Node low = sift_mk(state, x, f00, f10);
+            const Node high = sift_mk(state, x, f01, f11);
+            unique_erase(n);
+            m_nodes[n].var = y;
+            m_nodes[n].low = low;
+            m_nodes[n].high = high;
+            unique_insert(n);
+            sift_release(state, f0);
+            sift_release(state, f1);
+        }
+        std::erase_if(state.nodes[x], [&](Node n) { return m_nodes[n].var != x; });
+        std::erase_if(state.nodes[y], [&](Node n) { return m_nodes[n].var != y; });
+        state.nodes[y].insert(state.nodes[y].end(), rewrite.begin(), rewrite.end());
+    }
+
+public:
+    explicit BddManager(std::uint32_t num_vars = 0, std::size_t cache_size = 1 << 18)
+            : m_buckets(1 << 12, nil), m_cache(std::bit_ceil(cache_size)) {
+        m_nodes.push_back({terminal_var, zero, zero, nil});
+        m_nodes.push_back({terminal_var, one, one, nil});
+        m_ext_refs.assign(2, 0);
+        add_vars(num_vars);
+    }
+
+    BddManager(const BddManager &) = delete;
+    BddManager &operator=(const BddManager &) = delete;
+
+    /// Appends variables at the bottom of the order; returns the first new id.
+    std::uint32_t add_vars(std::uint32_t count) {
+        const auto first = static_cast<std::uint32_t>(m_var2level.size());
+        for (std::uint32_t i = 0; i < count; ++i) {
+            m_var2level.push_back(first + i);
+            m_level2var.push_back(first + i);
+        }
+        return first;
+    }
+
+    [[nodiscard]] std::uint32_t num_vars() const noexcept {
+        return static_cast<std::uint32_t>(m_var2level.size());
+    }
+
+    /// Allocated nodes, including terminals and garbage not yet collected.
+    [[nodiscard]] std::size_t num_nodes() const noexcept {
+        return m_nodes.size() - m_free_count;
+    }
+
+    [[nodiscard]] auto var_order() const -> const std::vector<std::uint32_t> & {
+        return m_level2var;
+    }
+
+    void set_auto_reorder(bool enabled) noexcept {
+        m_auto_reorder = enabled;
+    }
+
+    void ref(Node n) noexcept {
+        ++m_ext_refs[n];
+    }
+
+    void deref(Node n) noexcept {
+        --m_ext_refs[n];
+    }
+
+    [[nodiscard]] std::uint32_t top_var(Node n) const {
+        return m_nodes[n].var;
+    }
+
+    [[nodiscard]] Node low(Node n) const {
+        return m_nodes[n].low;
+    }
+
+    [[nodiscard]] Node high(Node n) const {
+        return m_nodes[n].high;
+    }
+
+    Bdd constant(bool value);
+
+    Bdd var(std::uint32_t v);
+
+    Bdd ite(const Bdd &f, const Bdd &g, const Bdd &h);
+
+    Bdd exists(const Bdd &f, const Bdd &cube);
+
+    Bdd and_exists(const Bdd &f, const Bdd &g, const Bdd &cube);
+
+    Bdd rename(const Bdd &f, std::uint32_t perm);
+
+    /// Positive conjunction of the given variables, for quantification.
+    Bdd cube(std::span<const std::uint32_t> vars);
+
+    /// Registers a variable substitution for rename(); mapping[v] replaces v.
+    std::uint32_t add_permutation(std::vector<std::uint32_t> mapping) {
+        m_perms.push_back(std::move(mapping));
+        return static_cast<std::uint32_t>(m_perms.size() - 1);
+    }
+
+    /// Number of satisfying assignments over support_vars variables, which
+    /// must include the support of n.
+    [[nodiscard]] double sat_count(Node n, std::uint32_t support_vars) const {
+        std::unordered_map<Node, double> density;
+        std::function<double(Node)> rec = [&](Node f) -> double {
+            if (f <= one) {
+                return f == one ? 1.0 : 0.0;
+            }
+            if (auto it = density.find(f); it != density.end()) {
+                return it->second;
+            }
+            const double d = 0.5 * (rec(m_nodes[f].low) + rec(m_nodes[f].high));
+            density.emplace(f, d);
+            return d;
+        };
+        return std::ldexp(rec(n), static_cast<int>(support_vars));
+    }
+
+    /// Frees every node unreachable from a live handle and clears the cache.
+    /// Returns the number of nodes still allocated.
+    std::size_t gc() {
+        std::vector<bool> marked(m_nodes.size(), false);
+        marked[zero] = marked[one] = true;
+        std::vector<Node> stack;
+        for (Node n = 2; n < m_nodes.size(); ++n) {
+            if (m_ext_refs[n] != 0 && m_nodes[n].var != free_var) {
+                stack.push_back(n);
+            }
+        }
+        while (!stack.empty()) {
+            const Node n = stack.back();
+            stack.pop_back();
+            if (marked[n]) {
+                continue;
+            }
+            marked[n] = true;
+            stack.push_back(m_nodes[n].low);
+            stack.push_back(m_nodes[n].high);
+        }
+        m_free = nil;
+        m_free_count = 0;
+        for (auto n = static_cast<Node>(m_nodes.size() - 1); n >= 2; --n) {
+            if (!marked[n]) {
+                m_nodes[n] = {free_var, zero, zero, m_free};
+                m_free = n;
+                ++m_free_count;
+            }
+        }
+        rehash(m_buckets.size());
+        std::fill(m_cache.begin(), m_cache.end(), CacheEntry{});
+        return num_nodes();
+    }
+
+    /// Rudell's sifting: moves each variable, largest level first, through
+    /// the whole order and leaves it at the position with the fewest nodes.
+    /// Garbage is collected once before and once after; in between, node
+    /// counts are kept exact swap by swap.
+    void reorder_sift(double max_growth = 1.2) {
+        const auto n = num_vars();
+        if (n < 2) {
+            return;
+        }
+        gc();
+        SiftState state;
+        state.refs.assign(m_ext_refs.begin(), m_ext_refs.end());
+        state.nodes.resize(n);
+        for (Node v = 2; v < m_nodes.size(); ++v) {
+            if (m_nodes[v].var != free_var) {
+                ++state.refs[m_nodes[v].low];
+                ++state.refs[m_nodes[v].high];
+                state.nodes[m_nodes[v].var].push_back(v);
+            }
+        }
+        state.live = num_nodes();
+        std::vector<std::uint32_t> vars(m_level2var.begin(), m_level2var.end());
+        std::sort(vars.begin(), vars.end(), [&](auto a, auto b) {
+            return state.nodes[a].size() > state.nodes[b].size();
+        });
+
+        for (auto var: vars) {
+            auto pos = m_var2level[var];
+            std::size_t best_size = state.live;
+            auto best_pos = pos;
+            while (pos + 1 < n) {
+                swap_levels(state, pos++);
+                if (state.live < best_size) {
+                    best_size = state.live;
+                    best_pos = pos;
+                } else if (static_cast<double>(state.live) > max_growth * static_cast<double>(best_size)) {
+                    break;
+                }
+            }
+            while (pos > 0) {
+                swap_levels(state, --pos);
+                if (state.live < best_size) {
+                    best_size = state.live;
+                    best_pos = pos;
+                } else if (static_cast<double>(state.live) > max_growth * static_cast<double>(best_size)) {
+                    break;
+                }
+            }
+            while (pos < best_pos) {
+                swap_levels(state, pos++);
+            }
+            while (pos > best_pos) {
+                swap_levels(state, --pos);
+            }
+        }
+        gc();
+    }
+};
+
+
+/// Reference-counted handle to a BDD node; keeps the node alive across
+/// garbage collections. The manager must outlive all of its handles.
+class Bdd {
+
+private:
+    BddManager *m_mgr = nullptr;
+    BddManager::Node m_node = BddManager::zero;
+
+public:
+    Bdd() = default;
+
+    Bdd(BddManager &mgr, BddManager::Node node) : m_mgr(&mgr), m_node(node) {
+        m_mgr->ref(m_node);
+    }
+
+    Bdd(const Bdd &other) : m_mgr(other.m_mgr), m_node(other.m_node) {
+        if (m_mgr) {
+            m_mgr->ref(m_node);
+        }
+    }
+
+    Bdd(Bdd &&other) noexcept: m_mgr(std::exchange(other.m_mgr, nullptr)), m_node(other.m_node) {}
+
+    ~Bdd() {
+        if (m_mgr) {
+            m_mgr->deref(m_node);
+        }
+    }
+
+    Bdd &operator=(Bdd other) noexcept {
+        std::swap(m_mgr, other.m_mgr);
+        std::swap(m_node, other.m_node);
+        return *this;
+    }
+
+    [[nodiscard]] BddManager::Node node() const noexcept {
+        return m_node;
+    }
+
+    [[nodiscard]] BddManager &manager() const noexcept {
+        return *m_mgr;
+    }
+
+    [[nodiscard]] bool is_zero() const noexcept {
+        return m_node == BddManager::zero;
+    }
+
+    [[nodiscard]] bool is_one() const noexcept {
+        return m_node == BddManager::one;
+    }
+
+    Bdd operator!() const {
+        return m_mgr->ite(*this, m_mgr->constant(false), m_mgr->constant(true));
+    }
+
+    Bdd operator&(const Bdd &other) const {
+        return m_mgr->ite(*this, other, m_mgr->constant(false));
+    }
+
+    Bdd operator|(const Bdd &other) const {
+        return m_mgr->ite(*this, m_mgr->constant(true), other);
+    }
+
+    Bdd operator^(const Bdd &other) const {
+        return m_mgr->ite(*this, !other, other);
+    }
+
+    /// Set difference.
+    Bdd operator-(const Bdd &other) const {
+        return m_mgr->ite(other, m_mgr->constant(false), *this);
+    }
+
+    Bdd &operator&=(const Bdd &other) {
+        return *this = *this & other;
+    }
+
+    Bdd &operator|=(const Bdd &other) {
+        return *this = *this | other;
+    }
+
+    friend bool operator==(const Bdd &lhs, const Bdd &rhs) noexcept {
+        return lhs.m_node == rhs.m_node;
+    }
+};
+
+inline Bdd BddManager::constant(bool value) {
+    return {*this, value ? one : zero};
+}
+
+inline Bdd BddManager::var(std::uint32_t v) {
+    maybe_collect();
+    return {*this, mk(v, zero, one)};
+}
+
+inline Bdd BddManager::ite(const Bdd &f, const Bdd &g, const Bdd &h) {
+    maybe_collect();
+    return {*this, ite_rec(f.node(), g.node(), h.node())};
+}
+
+inline Bdd BddManager::exists(const Bdd &f, const Bdd &cube) {
+    maybe_collect();
+    return {*this, exists_rec(f.node(), cube.node())};
+}
+
+inline Bdd BddManager::and_exists(const Bdd &f, const Bdd &g, const Bdd &cube) {
+    maybe_collect();
+    return {*this, and_exists_rec(f.node(), g.node(), cube.node())};
+}
+
+inline Bdd BddManager::rename(const Bdd &f, std::uint32_t perm) {
+    maybe_collect();
+    return {*this, rename_rec(f.node(), perm)};
+}
+
+inline Bdd BddManager::cube(std::span<const std::uint32_t> vars) {
+    Bdd result = constant(true);
+    for (auto v: vars) {
+        result &= var(v);
+    }
+    return result;
+}
+
+
+/// Symbolic Kripke frame over states encoded as state_bits-wide bit vectors.
+/// Current-state bit i is BDD variable 2i and its next-state copy is 2i + 1,
+/// so the transition relation T(x, x') starts out with an interleaved order.
+class SymbolicKripkeFrame {
+
+private:
+    std::unique_ptr<BddManager> m_mgr;
+    std::uint32_t m_bits;
+    Bdd m_transitions;
+    Bdd m_initial;
+    std::vector<Bdd> m_propositions;
+    Bdd m_current_cube;
+    Bdd m_next_cube;
+    std::uint32_t m_to_next = 0;
+    std::uint32_t m_to_current = 0;
+
+    Bdd encode(std::size_t idx, bool next) {
+        Bdd result = m_mgr->constant(true);
+        for (std::uint32_t i = 0; i < m_bits; ++i) {
+            const auto v = next ? next_var(i) : current_var(i);
+            result &= ((idx >> i) & 1u) ? v : !v;
+        }
+        return result;
+    }
+
+public:
+    explicit SymbolicKripkeFrame(std::uint32_t state_bits)
+            : m_mgr(std::make_unique<BddManager>(2 * state_bits)), m_bits(state_bits) {
+        m_transitions = m_mgr->constant(false);
+        m_initial = m_mgr->constant(false);
+        std::vector<std::uint32_t> current, next;
+        std::vector<std::uint32_t> to_next(2 * state_bits), to_current(2 * state_bits);
+        for (std::uint32_t i = 0; i < state_bits; ++i) {
+            current.push_back(2 * i);
+            next.push_back(2 * i + 1);
+            to_next[2 * i] = to_next[2 * i + 1] = 2 * i + 1;
+            to_current[2 * i] = to_current[2 * i + 1] = 2 * i;
+        }
+        m_current_cube = m_mgr->cube(current);
+        m_next_cube = m_mgr->cube(next);
+        m_to_next = m_mgr->add_permutation(std::move(to_next));
+        m_to_current = m_mgr->add_permutation(std::move(to_current));
+    }
+
+    /// Encodes an explicit frame, numbering states by their index.
+    template<KripkeFrameLike Frame>
+    static SymbolicKripkeFrame from_explicit(const Frame &frame) {
+        std::uint32_t bits = 1;
+        while ((std::size_t{1} << bits) < frame.num_states()) {
+            ++bits;
+        }
+        SymbolicKripkeFrame result(bits);
+        for (std::size_t from = 0; from < frame.num_states(); ++from) {
+            const Bdd source = result.state(from);
+            Bdd targets = result.manager().constant(false);
+            for (auto to: frame.successors(from)) {
+                targets |= result.encode(to, true);
+            }
+            result.add_transitions(source & targets);
+        }
+        if constexpr (Frame::has_proposition_labels) {
+            for (std::size_t p = 0; p < frame.num_propositions(); ++p) {
+                Bdd states = result.manager().constant(false);
+                frame.states_with(p).for_each([&](std::size_t idx) { states |= result.state(idx); });
+                result.set_proposition(p, states);
+            }
+        }
+        return result;
+    }
+
+    [[nodiscard]] BddManager &manager() const noexcept {
+        return *m_mgr;
+    }
+
+    [[nodiscard]] std::uint32_t state_bits() const noexcept {
+        return m_bits;
+    }
+
+    [[nodiscard]] Bdd current_var(std::uint32_t bit) const {
+        return m_mgr->var(2 * bit);
+    }
+
+    [[nodiscard]] Bdd next_var(std::uint32_t bit) const {
+        return m_mgr->var(2 * bit + 1);
+    }
+
+    /// The singleton set holding the state with the given index.
+    [[nodiscard]] Bdd state(std::size_t idx) {
+        return encode(idx, false);
+    }
+
+    /// Adds the pairs of rel, a relation over current and next variables.
+    void add_transitions(const Bdd &rel) {
+        m_transitions |= rel;
+    }
+
+    void add_initial(const Bdd &states) {
+        m_initial |= states;
+    }
+
+    void set_proposition(std::size_t prop, const Bdd &states) {
+        if (m_propositions.size() <= prop) {
+            m_propositions.resize(prop + 1, m_mgr->constant(false));
+        }
+        m_propositions[prop] = states;
+    }
+
+    [[nodiscard]] auto transitions() const -> const Bdd & {
+        return m_transitions;
+    }
+
+    [[nodiscard]] auto initial() const -> const Bdd & {
+        return m_initial;
+    }
+
+    [[nodiscard]] auto states_with(std::size_t prop) const -> const Bdd & {
+        return m_propositions[prop];
+    }
+
+    [[nodiscard]] double count_states(const Bdd &states) const {
+        return m_mgr->sat_count(m_mgr->exists(states, m_next_cube).node(), m_bits);
+    }
+
+    /// Successors of a state set: (exists x. S(x) & T(x, x'))[x' := x].
+    [[nodiscard]] Bdd image(const Bdd &states) const {
+        return m_mgr->rename(m_mgr->and_exists(states, m_transitions, m_current_cube), m_to_current);
+    }
+
+    /// Predecessors of a state set: exists x'. T(x, x') & S(x').
+    [[nodiscard]] Bdd preimage(const Bdd &states) const {
+        return m_mgr->and_exists(m_transitions, m_mgr->rename(states, m_to_next), m_next_cube);
+    }
+
+    /// States reachable from `from` (the initial states by default).
+    [[nodiscard]] Bdd reachable(const Bdd &from) const {
+        Bdd reached = from;
+        Bdd frontier = from;
+        while (!frontier.is_zero()) {
+            frontier = image(frontier) - reached;
+            reached |= frontier;
+        }
+        return reached;
+    }
+
+    [[nodiscard]] Bdd reachable() const {
+        return reachable(m_initial);
+    }
+
+    [[nodiscard]] Bdd ex(const Bdd &phi) const {
+        return preimage(phi);
+    }
+
+    /// E[phi U psi] as the least fixpoint Z = psi | (phi & EX Z).
+    [[nodiscard]] Bdd eu(const Bdd &phi, const Bdd &psi) const {
+        Bdd z = psi;
+        for (;;) {
+            Bdd next = psi | (phi & preimage(z));
+            if (next == z) {
+                return z;
+            }
+            z = std::move(next);
+        }
+    }
+
+    /// EG phi as the greatest fixpoint Z = phi & EX Z.
+    [[nodiscard]] Bdd eg(const Bdd &phi) const {
+        Bdd z = phi;
+        for (;;) {
+            Bdd next = z & preimage(z);
+            if (next == z) {
+                return z;
+            }
+            z = std::move(next);
+        }
+    }
+};
+
+
+/// Open-addressing table keyed by 64-bit state fingerprints. Storing only the
+/// fingerprint instead of the state (hash compaction) costs 8 bytes per
+/// visited state; two distinct states collide with probability ~n^2 / 2^65,
+/// in which case the second one is treated as already visited.
+template<typename Value = std::monostate>
+class FingerprintTable {
+
+public:
+    static constexpr bool has_values = !std::is_same_v<Value, std::monostate>;
+
+private:
+    static constexpr std::uint64_t empty = 0;
+
+    std::vector<std::uint64_t> m_keys;
+    std::vector<Value> m_values;
+    std::size_t m_size = 0;
+
+    static std::uint64_t normalize(std::uint64_t fp) noexcept {
+        return fp == empty ? 1 : fp;
+    }
+
+    [[nodiscard]] std::size_t probe(std::uint64_t fp) const noexcept {
+        const std::size_t mask = m_keys.size() - 1;
+        std::size_t slot = static_cast<std::size_t>(fp) & mask;
+        while (m_keys[slot] != empty && m_keys[slot] != fp) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void grow() {
+        std::vector<std::uint64_t> keys(m_keys.size() * 2, empty);
+        std::vector<Value> values(has_values ? keys.size() : 0);
+        std::swap(keys, m_keys);
+        std::swap(values, m_values);
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] != empty) {
+                const auto slot = probe(keys[i]);
+                m_keys[slot] = keys[i];
+                if constexpr (has_values) {
+                    m_values[slot] = std::move(values[i]);
+                }
+            }
+        }
+    }
+
+    /// Returns the slot of fp and whether it was newly claimed.
+    std::pair<std::size_t, bool> claim(std::uint64_t fp) {
+        if (4 * (m_size + 1) > 3 * m_keys.size()) {
+            grow();
+        }
+        const auto slot = probe(fp);
+        if (m_keys[slot] == fp) {
+            return {slot, false};
+        }
+        m_keys[slot] = fp;
+        ++m_size;
+        return {slot, true};
+    }
+
+public:
+    explicit FingerprintTable(std::size_t capacity = 1024)
+            : m_keys(std::bit_ceil(std::max<std::size_t>(capacity, 16)), empty),
+              m_values(has_values ? m_keys.size() : 0) {}
+
+    /// Records fp; returns true if it was not present before.
+    bool insert(std::uint64_t fp) requires (!has_values) {
+        return claim(normalize(fp)).second;
+    }
+
+    /// Maps fp to value unless already present; returns the stored value and
+    /// whether the insertion took place.
+    std::pair<Value &, bool> try_emplace(std::uint64_t fp, Value value) requires has_values {
+        const auto [slot, inserted] = claim(normalize(fp));
+        if (inserted) {
+            m_values[slot] = std::move(value);
+        }
+        return {m_values[slot], inserted};
+    }
+
+    [[nodiscard]] bool contains(std::uint64_t fp) const {
+        return m_keys[probe(normalize(fp))] != empty;
+    }
+
+    [[nodiscard]] auto find(std::uint64_t fp) const -> const Value * requires has_values {
+        const auto slot = probe(normalize(fp));
+        return m_keys[slot] == empty ? nullptr : &m_values[slot];
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_size;
+    }
+
+    [[nodiscard]] std::size_t memory_bytes() const noexcept {
+        return m_keys.size() * sizeof(std::uint64_t) + m_values.size() * sizeof(Value);
+    }
+
+    void clear() {
+        std::fill(m_keys.begin(), m_keys.end(), empty);
+        m_size = 0;
+    }
+};
+
+using FingerprintSet = FingerprintTable<>;
+
+
+/// A model given implicitly by its initial states and a successor function
+/// that reports each successor of a state through a callback.
+template<typename G>
+concept StateGenerator = requires(const G &gen, const typename G::StateType &state,
+                                  const std::function<void(const typename G::StateType &)> &emit) {
+    typename G::StateType;
+    { gen.initial_states() } -> std::convertible_to<std::vector<typename G::StateType>>;
+    gen.successors(state, emit);
+};
+
+/// A generator that also labels its states, so it can be materialized as a KripkeFrame.
+template<typename G>
+concept LabelledStateGenerator = StateGenerator<G> && requires(const G &gen, const typename G::StateType &state) {
+    typename G::LabelType;
+    { gen.label(state) } -> std::convertible_to<typename G::LabelType>;
+};
+
+
+struct ExplorationStats {
+    std::size_t states = 0;
+    std::size_t transitions = 0;
+    std::size_t max_frontier = 0;
+    std::size_t visited_bytes = 0;
+    bool complete = true;
+    /// Checkpoints written, and states restored from one on resume.
+    std::size_t checkpoints = 0;
+    std::size_t resumed_states = 0;
+};
+
+
+/// Where and how often StateSpaceExplorer::build_frame checkpoints.
+struct CheckpointOptions {
+    std::filesystem::path path;
+    /// Expanded states between checkpoints; 0 is treated as 1.
+    std::size_t interval = std::size_t{1} << 20;
+};
+
+/// Header of an exploration checkpoint, followed by the states, the labels
+/// (an array, or one bitset column per proposition), and the CSR successor
+/// offsets and targets of the first `expanded` states. The frontier is the
+/// unexpanded tail of the states, and the visited index is rebuilt from the
+/// states on resume, so neither is stored separately.
+struct CheckpointHeader {
+    static constexpr char expected_magic[8] = {'L', 'A', 'K', 'E', 'C', 'K', 'P', 'T'};
+    static constexpr std::uint32_t current_version = 1;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t state_size;
+    FrameFileHeader::LabelKind label_kind;
+    std::uint32_t label_size;
+    std::uint64_t num_states;
+    std::uint64_t expanded;
+    std::uint64_t num_transitions;
+    /// Transitions generated so far, including ones to already known states.
+    std::uint64_t generated;
+};
+
+/// Buffered writes to a raw file descriptor. Uses no heap memory, so it is
+/// safe in a forked child of a multi-threaded process.
+class FdWriter {
+
+private:
+    int m_fd;
+    bool m_ok;
+    std::size_t m_used = 0;
+    std::array<char, 1 << 16> m_buffer;
+
+public:
+    explicit FdWriter(int fd) noexcept : m_fd(fd), m_ok(fd >= 0) {}
+
+    void write(const void *data, std::size_t bytes) noexcept {
+        const auto *p = static_cast<const char *>(data);
+        // Blocks at least as large as the buffer bypass it.
+        if (bytes >= m_buffer.size()) {
+            flush();
+            put(p, bytes);
+            return;
+        }
+        while (bytes > 0 && m_ok) {
+            if (m_used == m_buffer.size()) {
+                flush();
+            }
+            const auto chunk = std::min(bytes, m_buffer.size() - m_used);
+            std::memcpy(m_buffer.data() + m_used, p, chunk);
+            m_used += chunk;
+            p += chunk;
+            bytes -= chunk;
+        }
+    }
+
+    void flush() noexcept {
+        put(m_buffer.data(), m_used);
+        m_used = 0;
+    }
+
+    [[nodiscard]] bool ok() const noexcept {
+        return m_ok;
+    }
+
+private:
+    void put(const char *data, std::size_t bytes) noexcept {
+        std::size_t done = 0;
+        while (done < bytes && m_ok) {
+            const auto written = ::write(m_fd, data + done, bytes - done);
+            m_ok = written > 0;
+            done += m_ok ? static_cast<std::size_t>(written) : 0;
+        }
+    }
+};
+
+/// Buffered sequential reader of fixed-size records, the counterpart of
+/// FdWriter. A trailing partial record counts as a read error.
+template<typename Record> requires std::is_trivially_copyable_v<Record>
+class FdReader {
+
+private:
+    int m_fd;
+    bool m_ok;
+    std::vector<Record> m_buffer;
+    std::size_t m_next = 0;
+    std::size_t m_size = 0;
+    std::uint64_t m_bytes = 0;
+
+    void refill() noexcept {
+        auto *p = reinterpret_cast<char *>(m_buffer.data());
+        const std::size_t want = m_buffer.size() * sizeof(Record);
+        std::size_t got = 0;
+        while (got < want && m_ok) {
+            const auto n = ::read(m_fd, p + got, want - got);
+            m_ok = n >= 0;
+            if (n <= 0) {
+                break;
+            }
+            got += static_cast<std::size_t>(n);
+        }
+        m_ok = m_ok && got % sizeof(Record) == 0;
+        m_size = got / sizeof(Record);
+        m_next = 0;
+        m_bytes += got;
+    }
+
+public:
+    FdReader(int fd, std::size_t buffer_records) : m_fd(fd), m_ok(fd >= 0), m_buffer(std::max<std::size_t>(buffer_records, 1)) {
+        refill();
+    }
+
+    /// The current record, or nullptr once the input is exhausted.
+    [[nodiscard]] const Record *peek() const noexcept {
+        return m_next < m_size ? &m_buffer[m_next] : nullptr;
+    }
+
+    void advance() noexcept {
+        if (++m_next == m_size && m_size == m_buffer.size()) {
+            refill();
+        }
+    }
+
+    [[nodiscard]] bool ok() const noexcept {
+        return m_ok;
+    }
+
+    [[nodiscard]] std::uint64_t bytes_read() const noexcept {
+        return m_bytes;
+    }
+};
+
+/// Breadth-first exploration of the states reachable in a generator. Only the
+/// frontier holds full states; visited states are kept as fingerprints.
+template<StateGenerator Generator, typename Hash = std::hash<typename Generator::StateType>>
+class StateSpaceExplorer {
+
+public:
+    using StateType = typename Generator::StateType;
+
+private:
+    const Generator &m_gen;
+    Hash m_hash;
+    std::size_t m_max_states = static_cast<std::size_t>(-1);
+
+public:
+    explicit StateSpaceExplorer(const Generator &gen, Hash hash = {}) : m_gen(gen), m_hash(std::move(hash)) {}
+
+    /// Stops exploration after this many distinct states.
+    void set_state_limit(std::size_t limit) noexcept {
+        m_max_states = limit;
+    }
+
+    [[nodiscard]] std::uint64_t fingerprint(const StateType &state) const {
+        return mix64(static_cast<std::uint64_t>(m_hash(state)));
+    }
+
+    /// Calls on_state once per reachable state, in BFS order. If on_state
+    /// returns bool, returning false stops the search.
+    template<std::invocable<const StateType &> Visitor>
+    ExplorationStats explore(Visitor &&on_state) const {
+        ExplorationStats stats;
+        FingerprintSet visited;
+        std::vector<StateType> frontier, next;
+        bool stop = false;
+
+        auto discover = [&](const StateType &state, std::vector<StateType> &into) {
+            if (stop || !visited.insert(fingerprint(state))) {
+                return;
+            }
+            ++stats.states;
+            if constexpr (std::is_convertible_v<std::invoke_result_t<Visitor &, const StateType &>, bool>) {
+                stop = !on_state(state);
+            } else {
+                on_state(state);
+            }
+            if (stats.states >= m_max_states) {
+                stop = true;
+            }
+            into.push_back(state);
+        };
+
+        for (const auto &state: m_gen.initial_states()) {
+            discover(state, frontier);
+        }
+        while (!frontier.empty() && !stop) {
+            stats.max_frontier = std::max(stats.max_frontier, frontier.size());
+            for (const auto &state: frontier) {
+                m_gen.successors(state, [&](const StateType &succ) {
+                    ++stats.transitions;
+                    discover(succ, next);
+                });
+                if (stop) {
+                    break;
+                }
+            }
+            frontier.swap(next);
+            next.clear();
+        }
+        stats.complete = !stop;
+        stats.visited_bytes = visited.memory_bytes();
+        return stats;
+    }
+
+    ExplorationStats explore() const {
+        return explore([](const StateType &) {});
+    }
+
+    /// Materializes the reachable part of the generator. Initial states get
+    /// the lowest indices; the BFS queue holds indices into the frame itself.
+    /// States are interned in the frame, so unlike explore() this is exact
+    /// and needs std::hash and == on StateType. With a state limit, no
+    /// states are added past it and transitions to them are dropped.
+    auto build_frame(ExplorationStats *stats = nullptr) const
+    requires LabelledStateGenerator<Generator> && KripkeFrame<StateType, typename Generator::LabelType>::has_state_hash {
+        return build_frame(nullptr, stats);
+    }
+
+    /// build_frame that survives crashes: every checkpoint.interval expanded
+    /// states the partial frame is written to checkpoint.path, and if that
+    /// file exists when called, exploration resumes from it instead of
+    /// starting over. Checkpoints are written by a forked child from a
+    /// copy-on-write snapshot of the process, so exploration pauses only for
+    /// the fork; a new one is skipped while the previous is still being written.
+    /// A run that completes removes the checkpoint, so the next call starts
+    /// over; one stopped by the state limit keeps it for a later resume.
+    auto build_frame(const CheckpointOptions &checkpoint, ExplorationStats *stats = nullptr) const
+    requires LabelledStateGenerator<Generator> && KripkeFrame<StateType, typename Generator::LabelType>::has_state_hash &&
+             std::is_trivially_copyable_v<StateType> && std::is_trivially_copyable_v<typename Generator::LabelType> {
+        return build_frame(&checkpoint, stats);
+    }
+
+private:
+    template<typename Label>
+    static bool write_checkpoint(const KripkeFrame<StateType, Label> &frame, std::size_t expanded,
+                                 std::uint64_t generated, const char *tmp_path, const char *path) noexcept {
+        const int fd = ::open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        FdWriter out(fd);
+        const std::size_t n = frame.num_states();
+        CheckpointHeader header{};
+        std::copy(std::begin(CheckpointHeader::expected_magic), std::end(CheckpointHeader::expected_magic), header.magic);
+        header.version = CheckpointHeader::current_version;
+        header.state_size = sizeof(StateType);
+        header.num_states = n;
+        header.expanded = expanded;
+        header.generated = generated;
+        for (std::size_t v = 0; v < expanded; ++v) {
+            header.num_transitions += frame.successors(v).size();
+        }
+        if constexpr (is_proposition_label_v<Label>) {
+            header.label_kind = FrameFileHeader::LabelKind::propositions;
+            header.label_size = static_cast<std::uint32_t>(Label{}.size());
+        } else {
+            header.label_kind = FrameFileHeader::LabelKind::array;
+            header.label_size = sizeof(Label);
+        }
+        out.write(&header, sizeof(header));
+        for (std::size_t v = 0; v < n; ++v) {
+            out.write(&frame.get_state(v), sizeof(StateType));
+        }
+        if constexpr (is_proposition_label_v<Label>) {
+            for (std::size_t p = 0; p < header.label_size; ++p) {
+                const auto words = frame.states_with(p).words();
+                out.write(words.data(), words.size() * 8);
+            }
+        } else {
+            for (std::size_t v = 0; v < n; ++v) {
+                out.write(&frame.get_label(v), sizeof(Label));
+            }
+        }
+        std::uint64_t offset = 0;
+        out.write(&offset, 8);
+        for (std::size_t v = 0; v < expanded; ++v) {
+            offset += frame.successors(v).size();
+            out.write(&offset, 8);
+        }
+        for (std::size_t v = 0; v < expanded; ++v) {
+            const auto succ = frame.successors(v);
+            out.write(succ.data(), succ.size() * 8);
+        }
+        out.flush();
+        const bool ok = out.ok() && ::fsync(fd) == 0;
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return ok && ::rename(tmp_path, path) == 0;
+    }
+
+    /// Restores a checkpoint into an empty frame; returns the number of
+    /// expanded states and transitions generated, or nullopt if the file is
+    /// missing, does not match this generator's types, or its size
+    /// disagrees with the counts in its header.
+    template<typename Label>
+    static auto read_checkpoint(const std::filesystem::path &path, KripkeFrame<StateType, Label> &frame)
+    -> std::optional<std::pair<std::size_t, std::uint64_t>> {
+        std::ifstream in(path, std::ios::binary);
+        CheckpointHeader header{};
+        if (!in.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+            return std::nullopt;
+        }
+        bool valid = std::equal(std::begin(header.magic), std::end(header.magic), CheckpointHeader::expected_magic) &&
+                     header.version == CheckpointHeader::current_version &&
+                     header.state_size == sizeof(StateType) &&
+                     header.expanded <= header.num_states;
+        if constexpr (is_proposition_label_v<Label>) {
+            valid = valid && header.label_kind == FrameFileHeader::LabelKind::propositions &&
+                    header.label_size == Label{}.size();
+        } else {
+            valid = valid && header.label_kind == FrameFileHeader::LabelKind::array && header.label_size == sizeof(Label);
+        }
+        // The counts must describe exactly the bytes in the file before
+        // anything is allocated from them; bounding them by the file size
+        // first keeps the arithmetic from overflowing.
+        std::error_code error;
+        const std::uint64_t file_bytes = std::filesystem::file_size(path, error);
+        valid = valid && !error && header.num_states <= file_bytes && header.num_transitions <= file_bytes / 8;
+        if (valid) {
+            const std::uint64_t n = header.num_states;
+            const std::uint64_t label_bytes = is_proposition_label_v<Label>
+                                              ? header.label_size * ((n + 63) / 64 * 8)
+                                              : n * sizeof(Label);
+            valid = sizeof(header) + n * sizeof(StateType) + label_bytes + (header.expanded + 1) * 8 +
+                    header.num_transitions * 8 == file_bytes;
+        }
+        if (!valid) {
+            return std::nullopt;
+        }
+        const std::size_t n = header.num_states;
+        auto read = [&](void *data, std::size_t bytes) {
+            return static_cast<bool>(in.read(static_cast<char *>(data), static_cast<std::streamsize>(bytes)));
+        };
+        std::vector<StateType> states(n);
+        std::vector<Label> labels(n);
+        bool ok = read(states.data(), n * sizeof(StateType));
+        if constexpr (is_proposition_label_v<Label>) {
+            std::vector<std::uint64_t> words((n + 63) / 64);
+            for (std::size_t p = 0; p < header.label_size && ok; ++p) {
+                ok = read(words.data(), words.size() * 8);
+                const StateSet column(words, n);
+                column.for_each([&](std::size_t v) { labels[v].set(p); });
+            }
+        } else {
+            ok = ok && read(labels.data(), n * sizeof(Label));
+        }
+        std::vector<std::uint64_t> offsets(header.expanded + 1);
+        std::vector<std::size_t> targets(header.num_transitions);
+        // Offsets must run from 0 to num_transitions without decreasing, or the
+        // rows below would index past targets.
+        ok = ok && read(offsets.data(), offsets.size() * 8) && offsets.front() == 0 &&
+             offsets.back() == header.num_transitions && std::is_sorted(offsets.begin(), offsets.end()) &&
+             read(targets.data(), targets.size() * 8);
+        if (!ok || std::any_of(targets.begin(), targets.end(), [&](auto t) { return t >= n; })) {
+            return std::nullopt;
+        }
+        for (std::size_t v = 0; v < n; ++v) {
+            frame.add_state(states[v], labels[v]);
+        }
+        for (std::size_t v = 0; v < header.expanded; ++v) {
+            for (auto k = offsets[v]; k < offsets[v + 1]; ++k) {
+                frame.add_transition(v, targets[k]);
+            }
+        }
+        return std::pair{static_cast<std::size_t>(header.expanded), header.generated};
+    }
+
+    auto build_frame(const CheckpointOptions *checkpoint, ExplorationStats *stats) const
+    requires LabelledStateGenerator<Generator> && KripkeFrame<StateType, typename Generator::LabelType>::has_state_hash {
+        using Label = typename Generator::LabelType;
+        KripkeFrame<StateType, Label> frame;
+        frame.enable_interning();
+        ExplorationStats local;
+
+        // Frame index of state, adding it if new; npos once the limit is reached.
+        auto intern = [&](const StateType &state) -> std::size_t {
+            if (const auto known = frame.find_state(state)) {
+                return *known;
+            }
+            if (frame.num_states() >= m_max_states) {
+                local.complete = false;
+                return StateSet::npos;
+            }
+            return frame.add_state(state, m_gen.label(state));
+        };
+
+        constexpr bool checkpointable = std::is_trivially_copyable_v<StateType> && std::is_trivially_copyable_v<Label>;
+        std::size_t from = 0;
+        std::string path, tmp_path;
+        ::pid_t writer = -1;
+        if constexpr (checkpointable) {
+            if (checkpoint) {
+                path = checkpoint->path.string();
+                tmp_path = path + ".tmp";
+                if (auto resumed = read_checkpoint(checkpoint->path, frame)) {
+                    std::tie(from, local.transitions) = *resumed;
+                    local.resumed_states = frame.num_states();
+                }
+            }
+        }
+        // Reap a finished writer; `block` waits for a running one.
+        auto reap = [&](bool block) {
+            int status = 0;
+            if (writer > 0 && ::waitpid(writer, &status, block ? 0 : WNOHANG) == writer) {
+                local.checkpoints += WIFEXITED(status) && WEXITSTATUS(status) == 0;
+                writer = -1;
+            }
+        };
+
+        if (from == 0) {
+            for (const auto &state: m_gen.initial_states()) {
+                intern(state);
+            }
+        }
+        // The checkpoint on disk already holds the frame as of `start`.
+        const std::size_t start = from;
+        const std::size_t interval = checkpoint ? std::max<std::size_t>(checkpoint->interval, 1) : 1;
+        for (; from < frame.num_states(); ++from) {
+            if constexpr (checkpointable) {
+                // Once the limit dropped a transition the frame is no longer a
+                // resumable prefix of the full one.
+                if (checkpoint && local.complete && from != start && from % interval == 0) {
+                    reap(false);
+                    if (writer < 0) {
+                        writer = ::fork();
+                        if (writer == 0) {
+                            ::_exit(write_checkpoint(frame, from, local.transitions, tmp_path.c_str(), path.c_str()) ? 0 : 1);
+                        }
+                    }
+                }
+            }
+            const StateType state = frame.get_state(from);
+            m_gen.successors(state, [&](const StateType &succ) {
+                ++local.transitions;
+                if (const auto to = intern(succ); to != StateSet::npos) {
+                    frame.add_transition(from, to);
+                }
+            });
+            local.max_frontier = std::max(local.max_frontier, frame.num_states() - from);
+        }
+        reap(true);
+        if constexpr (checkpointable) {
+            if (checkpoint && local.complete) {
+                ::unlink(path.c_str());
+                ::unlink(tmp_path.c_str());
+            }
+        }
+        local.states = frame.num_states();
+        local.visited_bytes = frame.interning_bytes();
+        if (stats) {
+            *stats = local;
+        }
+        return frame;
+    }
+};
+
+/// Fixed-capacity lock-free fingerprint set for concurrent exploration:
+/// linear probing where a bucket is claimed by a CAS from empty to the
+/// fingerprint, so concurrent inserts of the same state agree on one winner.
+class ConcurrentFingerprintSet {
+
+private:
+    static constexpr std::uint64_t empty = 0;
+
+    std::vector<std::atomic<std::uint64_t>> m_slots;
+    std::atomic<std::size_t> m_size{0};
+
+public:
+    enum class Insert {
+        inserted, present, full
+    };
+
+    explicit ConcurrentFingerprintSet(std::size_t capacity)
+            : m_slots(std::bit_ceil(std::max<std::size_t>(capacity, 16))) {}
+
+    Insert insert(std::uint64_t fp) noexcept {
+        fp = fp == empty ? 1 : fp;
+        const std::size_t mask = m_slots.size() - 1;
+        std::size_t slot = static_cast<std::size_t>(fp) & mask;
+        for (std::size_t probes = 0; probes < m_slots.size(); ++probes) {
+            std::uint64_t current = m_slots[slot].load(std::memory_order_relaxed);
+            if (current == empty) {
+                if (m_slots[slot].compare_exchange_strong(current, fp, std::memory_order_relaxed)) {
+                    m_size.fetch_add(1, std::memory_order_relaxed);
+                    return Insert::inserted;
+                }
+            }
+            if (current == fp) {
+                return Insert::present;
+            }
+            slot = (slot + 1) & mask;
+        }
+        return Insert::full;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_size.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept {
+        return m_slots.size();
+    }
+
+    [[nodiscard]] std::size_t memory_bytes() const noexcept {
+        return m_slots.size() * sizeof(std::uint64_t);
+    }
+};
+
+
+struct ExternalMemoryOptions {
+    /// Directory for layer, run and visited files; it must exist.
+    std::filesystem::path directory;
+    /// Successors buffered in memory before they are sorted and spilled as a run.
+    std::size_t memory_bytes = std::size_t{256} << 20;
+    /// Buffer of every sequential reader.
+    std::size_t io_bytes = std::size_t{1} << 20;
+    /// Runs merged at once; beyond that they are first merged in groups,
+    /// which bounds open files and reader buffers during a merge.
+    std::size_t fan_in = 64;
+};
+
+/// visited_bytes is the size of the visited file on disk.
+struct ExternalExplorationStats : ExplorationStats {
+    std::size_t levels = 0;
+    /// Sorted runs written over the whole search, including merged ones.
+    std::size_t runs = 0;
+    std::uint64_t bytes_read = 0;
+    std::uint64_t bytes_written = 0;
+};
+
+
+/// Breadth-first exploration that keeps frontiers and visited states on disk
+/// (delayed duplicate detection, Korf; Munagala and Ranade). Successors of a
+/// layer are buffered, sorted and spilled as runs; one merge pass over the
+/// runs and the sorted visited file then drops duplicates and writes both
+/// the next layer and the new visited file. All file access is sequential,
+/// and memory stays at memory_bytes plus fan_in + 1 io_bytes buffers.
+///
+/// States are ordered and compared by their bytes, so StateType must be
+/// trivially copyable without padding.
+template<StateGenerator Generator>
+requires std::is_trivially_copyable_v<typename Generator::StateType> &&
+         std::has_unique_object_representations_v<typename Generator::StateType>
+class ExternalMemoryExplorer {
+
+public:
+    using StateType = typename Generator::StateType;
+
+private:
+    const Generator &m_gen;
+    ExternalMemoryOptions m_options;
+
+    static bool less(const StateType &a, const StateType &b) noexcept {
+        return std::memcmp(&a, &b, sizeof(StateType)) < 0;
+    }
+
+    static bool equal(const StateType &a, const StateType &b) noexcept {
+        return std::memcmp(&a, &b, sizeof(StateType)) == 0;
+    }
+
+    [[nodiscard]] std::filesystem::path file(const std::string &name) const {
+        return m_options.directory / name;
+    }
+
+    [[nodiscard]] std::size_t io_records() const noexcept {
+        return std::max<std::size_t>(m_options.io_bytes / sizeof(StateType), 1);
+    }
+
+    /// Sorts and deduplicates buffer and writes it to path in one block.
+    static bool spill(std::vector<StateType> &buffer, const std::filesystem::path &path, ExternalExplorationStats &stats) {
+        std::sort(buffer.begin(), buffer.end(), less);
+        buffer.erase(std::unique(buffer.begin(), buffer.end(), equal), buffer.end());
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        FdWriter out(fd);
+        out.write(buffer.data(), buffer.size() * sizeof(StateType));
+        out.flush();
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        stats.bytes_written += buffer.size() * sizeof(StateType);
+        ++stats.runs;
+        buffer.clear();
+        return out.ok();
+    }
+
+    /// K-way merge of runs [first, first + count): calls sink once per
+    /// distinct state, in order. Returns false on read errors.
+    template<typename Sink>
+    bool merge_runs(std::size_t first, std::size_t count, ExternalExplorationStats &stats, Sink &&sink) const {
+        std::vector<int> fds;
+        std::vector<FdReader<StateType>> inputs;
+        inputs.reserve(count);
+        for (std::size_t r = first; r < first + count; ++r) {
+            fds.push_back(::open(file("run-" + std::to_string(r)).c_str(), O_RDONLY));
+            inputs.emplace_back(fds.back(), io_records());
+        }
+        // Min-heap of inputs by their current state.
+        const auto after = [&](std::size_t a, std::size_t b) { return less(*inputs[b].peek(), *inputs[a].peek()); };
+        std::vector<std::size_t> heap;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (inputs[i].peek()) {
+                heap.push_back(i);
+            }
+        }
+        std::make_heap(heap.begin(), heap.end(), after);
+        while (!heap.empty()) {
+            const StateType state = *inputs[heap.front()].peek();
+            sink(state);
+            while (!heap.empty() && equal(*inputs[heap.front()].peek(), state)) {
+                std::pop_heap(heap.begin(), heap.end(), after);
+                auto &input = inputs[heap.back()];
+                input.advance();
+                if (input.peek()) {
+                    std::push_heap(heap.begin(), heap.end(), after);
+                } else {
+                    heap.pop_back();
+                }
+            }
+        }
+        bool ok = true;
+        for (const auto &input: inputs) {
+            ok = ok && input.ok();
+            stats.bytes_read += input.bytes_read();
+        }
+        for (int fd: fds) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+        return ok;
+    }
+
+    /// Merges groups of fan_in runs until at most fan_in are left, so the
+    /// final merge keeps a bounded number of files and buffers open. On
+    /// failure the merged files are removed and runs is left as it was, so
+    /// the caller's cleanup of run-0 .. run-(runs - 1) covers the rest.
+    bool reduce_runs(std::size_t &runs, ExternalExplorationStats &stats) const {
+        const std::size_t fan_in = std::max<std::size_t>(m_options.fan_in, 2);
+        while (runs > fan_in) {
+            std::size_t merged = 0;
+            // Removes merged-0 .. merged-`merged`; ones already renamed are gone.
+            auto fail = [&] {
+                for (std::size_t r = 0; r <= merged; ++r) {
+                    ::unlink(file("merged-" + std::to_string(r)).c_str());
+                }
+                return false;
+            };
+            for (std::size_t first = 0; first < runs; first += fan_in, ++merged) {
+                const auto path = file("merged-" + std::to_string(merged));
+                const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                FdWriter out(fd);
+                const bool read = merge_runs(first, std::min(fan_in, runs - first), stats, [&](const StateType &state) {
+                    out.write(&state, sizeof(StateType));
+                    stats.bytes_written += sizeof(StateType);
+                });
+                out.flush();
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+                if (!read || !out.ok()) {
+                    return fail();
+                }
+            }
+            for (std::size_t r = 0; r < runs; ++r) {
+                ::unlink(file("run-" + std::to_string(r)).c_str());
+            }
+            for (std::size_t r = 0; r < merged; ++r) {
+                if (::rename(file("merged-" + std::to_string(r)).c_str(), file("run-" + std::to_string(r)).c_str()) != 0) {
+                    return fail();
+                }
+            }
+            stats.runs += merged;
+            runs = merged;
+        }
+        return true;
+    }
+
+    /// Merges the runs with the visited file. States not visited before are
+    /// appended to next_visited and layer and passed to on_new, which returns
+    /// false to stop; the rest of the visited file is copied regardless.
+    /// Returns false on I/O errors.
+    template<typename OnNew>
+    bool merge(std::size_t runs, const std::filesystem::path &visited, const std::filesystem::path &next_visited,
+               const std::filesystem::path &layer, ExternalExplorationStats &stats, OnNew &&on_new) const {
+        const int old_fd = ::open(visited.c_str(), O_RDONLY);
+        FdReader<StateType> old(old_fd, io_records());
+        const int visited_fd = ::open(next_visited.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        const int layer_fd = ::open(layer.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        FdWriter visited_out(visited_fd);
+        FdWriter layer_out(layer_fd);
+        auto emit_visited = [&](const StateType &state) {
+            visited_out.write(&state, sizeof(StateType));
+            stats.bytes_written += sizeof(StateType);
+        };
+
+        bool go = true;
+        const bool read = merge_runs(0, runs, stats, [&](const StateType &state) {
+            while (old.peek() && less(*old.peek(), state)) {
+                emit_visited(*old.peek());
+                old.advance();
+            }
+            if (old.peek() && equal(*old.peek(), state)) {
+                return;
+            }
+            emit_visited(state);
+            if (go) {
+                layer_out.write(&state, sizeof(StateType));
+                stats.bytes_written += sizeof(StateType);
+                go = on_new(state);
+            }
+        });
+        for (; old.peek(); old.advance()) {
+            emit_visited(*old.peek());
+        }
+        visited_out.flush();
+        layer_out.flush();
+        stats.bytes_read += old.bytes_read();
+        for (int fd: {old_fd, visited_fd, layer_fd}) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+        return read && old.ok() && visited_out.ok() && layer_out.ok();
+    }
+
+public:
+    ExternalMemoryExplorer(const Generator &gen, ExternalMemoryOptions options)
+            : m_gen(gen), m_options(std::move(options)) {}
+
+    /// Calls on_state once per reachable state, layer by layer; within a
+    /// layer states come in byte order. If on_state returns bool, returning
+    /// false stops the search. Returns nullopt if a file cannot be written
+    /// or read back. All files are removed before returning.
+    template<std::invocable<const StateType &> Visitor>
+    std::optional<ExternalExplorationStats> explore(Visitor &&on_state) const {
+        ExternalExplorationStats stats;
+        const std::size_t capacity = std::max<std::size_t>(m_options.memory_bytes / sizeof(StateType), 1);
+        std::vector<StateType> buffer;
+        buffer.reserve(capacity);
+        std::size_t runs = 0;
+        bool ok = true;
+        bool stop = false;
+        std::size_t layer_size = 0;
+
+        auto flush_run = [&] {
+            if (!buffer.empty()) {
+                ok = ok && spill(buffer, file("run-" + std::to_string(runs++)), stats);
+            }
+        };
+        auto on_new = [&](const StateType &state) {
+            ++stats.states;
+            ++layer_size;
+            if constexpr (std::is_convertible_v<std::invoke_result_t<Visitor &, const StateType &>, bool>) {
+                stop = !on_state(state);
+            } else {
+                on_state(state);
+            }
+            return !stop;
+        };
+        // Folds this level's runs into the visited file and writes the next
+        // layer, then drops the runs.
+        auto next_level = [&] {
+            layer_size = 0;
+            ok = ok && reduce_runs(runs, stats) && merge(runs, file("visited"), file("visited.next"), file("layer.next"), stats, on_new) &&
+                 ::rename(file("visited.next").c_str(), file("visited").c_str()) == 0 &&
+                 ::rename(file("layer.next").c_str(), file("layer").c_str()) == 0;
+            for (std::size_t r = 0; r < runs; ++r) {
+                ::unlink(file("run-" + std::to_string(r)).c_str());
+            }
+            runs = 0;
+            stats.max_frontier = std::max(stats.max_frontier, layer_size);
+        };
+
+        {
+            const int fd = ::open(file("visited").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            ok = fd >= 0;
+            if (ok) {
+                ::close(fd);
+            }
+        }
+        for (const auto &state: m_gen.initial_states()) {
+            buffer.push_back(state);
+            if (buffer.size() == capacity) {
+                flush_run();
+            }
+        }
+        flush_run();
+        next_level();
+
+        while (ok && !stop && layer_size != 0) {
+            ++stats.levels;
+            const int fd = ::open(file("layer").c_str(), O_RDONLY);
+            FdReader<StateType> layer(fd, io_records());
+            for (; layer.peek() && ok; layer.advance()) {
+                m_gen.successors(*layer.peek(), [&](const StateType &succ) {
+                    ++stats.transitions;
+                    buffer.push_back(succ);
+                    if (buffer.size() == capacity) {
+                        flush_run();
+                    }
+                });
+            }
+            ok = ok && layer.ok();
+            stats.bytes_read += layer.bytes_read();
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            flush_run();
+            next_level();
+        }
+
+        stats.complete = !stop;
+        stats.visited_bytes = stats.states * sizeof(StateType);
+        for (const char *name: {"visited", "visited.next", "layer", "layer.next"}) {
+            ::unlink(file(name).c_str());
+        }
+        if (!ok) {
+            return std::nullopt;
+        }
+        return stats;
+    }
+
+    std::optional<ExternalExplorationStats> explore() const {
+        return explore([](const StateType &) {});
+    }
+};
+
+struct ParallelExplorationStats : ExplorationStats {
+    std::vector<std::size_t> states_per_thread;
+    std::size_t steals = 0;
+};
+
+
+/// Multi-threaded exploration. Every worker owns a work stack; idle workers
+/// steal half of a victim's oldest entries. Visited states live in a shared
+/// ConcurrentFingerprintSet sized up front, so the table never resizes.
+template<StateGenerator Generator, typename Hash = std::hash<typename Generator::StateType>>
+class ParallelStateSpaceExplorer {
+
+public:
+    using StateType = typename Generator::StateType;
+
+private:
+    struct alignas(64) WorkQueue {
+        std::mutex mutex;
+        std::deque<StateType> items;
+    };
+
+    const Generator &m_gen;
+    Hash m_hash;
+    std::size_t m_capacity;
+
+public:
+    /// capacity bounds the number of distinct states; exploration stops
+    /// (incomplete) once the visited table is 90% full.
+    ParallelStateSpaceExplorer(const Generator &gen, std::size_t capacity, Hash hash = {})
+            : m_gen(gen), m_hash(std::move(hash)), m_capacity(capacity) {}
+
+    [[nodiscard]] std::uint64_t fingerprint(const StateType &state) const {
+        return mix64(static_cast<std::uint64_t>(m_hash(state)));
+    }
+
+    /// Like StateSpaceExplorer::explore, but on_state is called concurrently
+    /// from all workers and in no particular order.
+    template<std::invocable<const StateType &> Visitor>
+    ParallelExplorationStats explore(Visitor &&on_state, std::size_t num_threads = std::thread::hardware_concurrency()) const {
+        num_threads = std::max<std::size_t>(num_threads, 1);
+        ConcurrentFingerprintSet visited(m_capacity + m_capacity / 9 + 1);
+        const std::size_t limit = visited.capacity() / 10 * 9;
+        std::vector<WorkQueue> queues(num_threads);
+        std::atomic<std::size_t> pending{0};
+        std::atomic<std::size_t> transitions{0};
+        std::atomic<std::size_t> steals{0};
+        std::atomic<bool> stop{false};
+        // Written once per worker on exit; counting here would share cache lines.
+        std::vector<std::size_t> per_thread(num_threads, 0);
+
+        // Returns true if the state is new; the caller then owns a pending unit.
+        auto discover = [&](const StateType &state) {
+            if (stop.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            const auto result = visited.insert(fingerprint(state));
+            if (result == ConcurrentFingerprintSet::Insert::full || visited.size() > limit) {
+                stop.store(true, std::memory_order_relaxed);
+            }
+            if (result != ConcurrentFingerprintSet::Insert::inserted) {
+                return false;
+            }
+            if constexpr (std::is_convertible_v<std::invoke_result_t<Visitor &, const StateType &>, bool>) {
+                if (!on_state(state)) {
+                    stop.store(true, std::memory_order_relaxed);
+                }
+            } else {
+                on_state(state);
+            }
+            pending.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        };
+
+        {
+            std::size_t worker = 0;
+            for (const auto &state: m_gen.initial_states()) {
+                if (discover(state)) {
+                    ++per_thread[0];
+                    queues[worker++ % num_threads].items.push_back(state);
+                }
+            }
+        }
+
+        auto steal = [&](std::size_t self, std::vector<StateType> &loot) {
+            for (std::size_t k = 1; k < num_threads; ++k) {
+                auto &victim = queues[(self + k) % num_threads];
+                std::lock_guard lock(victim.mutex);
+                const std::size_t take = (victim.items.size() + 1) / 2;
+                for (std::size_t i = 0; i < take; ++i) {
+                    loot.push_back(std::move(victim.items.front()));
+                    victim.items.pop_front();
+                }
+                if (take != 0) {
+                    steals.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+            }
+        };
+
+        auto work = [&](std::size_t self) {
+            auto &own = queues[self];
+            std::vector<StateType> loot;
+            std::size_t local_transitions = 0;
+            std::size_t local_states = 0;
+            for (;;) {
+                std::optional<StateType> state;
+                {
+                    std::lock_guard lock(own.mutex);
+                    if (!own.items.empty()) {
+                        state.emplace(std::move(own.items.back()));
+                        own.items.pop_back();
+                    }
+                }
+                if (!state) {
+                    steal(self, loot);
+                    if (loot.empty()) {
+                        if (pending.load(std::memory_order_acquire) == 0) {
+                            break;
+                        }
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    state.emplace(std::move(loot.back()));
+                    loot.pop_back();
+                    std::lock_guard lock(own.mutex);
+                    for (auto &item: loot) {
+                        own.items.push_back(std::move(item));
+                    }
+                    loot.clear();
+                }
+                if (!stop.load(std::memory_order_relaxed)) {
+                    m_gen.successors(*state, [&](const StateType &succ) {
+                        ++local_transitions;
+                        if (discover(succ)) {
+                            ++local_states;
+                            std::lock_guard lock(own.mutex);
+                            own.items.push_back(succ);
+                        }
+                    });
+                }
+                pending.fetch_sub(1, std::memory_order_release);
+            }
+            transitions.fetch_add(local_transitions, std::memory_order_relaxed);
+            per_thread[self] += local_states;
+        };
+
+        {
+            std::vector<std::jthread> threads;
+            for (std::size_t t = 1; t < num_threads; ++t) {
+                threads.emplace_back(work, t);
+            }
+            work(0);
+        }
+
+        ParallelExplorationStats stats;
+        stats.states = visited.size();
+        stats.transitions = transitions.load();
+        stats.visited_bytes = visited.memory_bytes();
+        stats.complete = !stop.load();
+        stats.states_per_thread = std::move(per_thread);
+        stats.steals = steals.load();
+        return stats;
+    }
+
+    ParallelExplorationStats explore(std::size_t num_threads = std::thread::hardware_concurrency()) const {
+        return explore([](const StateType &) {}, num_threads);
+    }
+};
+
+/// HyperLogLog distinct-count sketch over 64-bit hashes: 4096 one-byte
+/// registers, about 1.6% standard error, and mergeable by register maximum.
+class CardinalitySketch {
+
+private:
+    static constexpr unsigned index_bits = 12;
+    static constexpr std::size_t num_registers = std::size_t{1} << index_bits;
+
+    std::array<std::uint8_t, num_registers> m_registers{};
+
+public:
+    void add(std::uint64_t hash) noexcept {
+        const auto idx = hash >> (64 - index_bits);
+        const auto rank = static_cast<std::uint8_t>(std::countl_zero((hash << index_bits) | (std::uint64_t{1} << (index_bits - 1))) + 1);
+        m_registers[idx] = std::max(m_registers[idx], rank);
+    }
+
+    void merge(const CardinalitySketch &other) noexcept {
+        for (std::size_t i = 0; i < num_registers; ++i) {
+            m_registers[i] = std::max(m_registers[i], other.m_registers[i]);
+        }
+    }
+
+    [[nodiscard]] double estimate() const noexcept {
+        constexpr double m = num_registers;
+        double sum = 0;
+        std::size_t zeros = 0;
+        for (auto r: m_registers) {
+            sum += std::ldexp(1.0, -static_cast<int>(r));
+            zeros += r == 0;
+        }
+        const double raw = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+        if (raw <= 2.5 * m && zeros != 0) {
+            return m * std::log(m / static_cast<double>(zeros));
+        }
+        return raw;
+    }
+};
+
+
+struct SwarmOptions {
+    /// Number of concurrent searches; 0 means one per hardware thread.
+    std::size_t workers = 0;
+    /// Bits of every worker's bitstate table.
+    std::size_t bitstate_bits = std::size_t{1} << 27;
+    /// Bits set per state; k = 3 keeps the omission rate low until the
+    /// table is around a tenth full.
+    unsigned hash_functions = 3;
+    std::chrono::milliseconds time_budget{1000};
+    /// Depth bound of every DFS; searches vary it between half and all of it.
+    std::size_t max_depth = 1'000'000;
+    std::uint64_t seed = 1;
+};
+
+struct SwarmWorkerStats {
+    /// Searches run; a worker starts a new one with a fresh seed when the last finished.
+    std::size_t searches = 0;
+    std::size_t states = 0;
+    std::size_t transitions = 0;
+    std::size_t max_depth = 0;
+    /// Set bits in the last search's table, as a fraction of its size.
+    double fill = 0;
+};
+
+struct SwarmStats {
+    std::vector<SwarmWorkerStats> workers;
+    /// Distinct states seen by any worker, estimated from merged sketches.
+    double estimated_states = 0;
+    /// False if the visitor stopped the swarm.
+    bool complete = true;
+};
+
+
+/// Swarm verification (Holzmann et al.): many independent depth-first
+/// searches run in parallel for a fixed time, each with its own successor
+/// order, hash seed and depth bound, and each remembering visited states in
+/// a bitstate table (a few bits per state, no collision resolution). A
+/// single search may miss states on hash collisions or depth cut-offs; the
+/// diversity across searches is what buys coverage of huge state spaces.
+template<StateGenerator Generator, typename Hash = std::hash<typename Generator::StateType>>
+class SwarmExplorer {
+
+public:
+    using StateType = typename Generator::StateType;
+
+private:
+    const Generator &m_gen;
+    Hash m_hash;
+
+    struct Frame {
+        std::vector<StateType> successors;
+        std::size_t next = 0;
+    };
+
+    /// Marks the state's bits; returns false if all were already set.
+    static bool visit(std::vector<std::uint64_t> &bits, std::uint64_t hash, unsigned k, std::size_t &set_bits) {
+        const std::size_t size = bits.size() * 64;
+        const auto h2 = mix64(hash) | 1;
+        bool fresh = false;
+        for (unsigned i = 0; i < k; ++i) {
+            const auto bit = (hash + i * h2) % size;
+            auto &word = bits[bit / 64];
+            const auto mask = std::uint64_t{1} << (bit % 64);
+            if (!(word & mask)) {
+                word |= mask;
+                ++set_bits;
+                fresh = true;
+            }
+        }
+        return fresh;
+    }
+
+public:
+    explicit SwarmExplorer(const Generator &gen, Hash hash = {}) : m_gen(gen), m_hash(std::move(hash)) {}
+
+    /// Runs the swarm until the time budget is spent. on_state is called for
+    /// every state a search visits, concurrently from all workers and
+    /// possibly several times per state; returning false stops the swarm.
+    template<std::invocable<const StateType &> Visitor>
+    SwarmStats explore(const SwarmOptions &options, Visitor &&on_state) const {
+        const auto deadline = std::chrono::steady_clock::now() + options.time_budget;
+        const std::size_t workers = options.workers != 0
+                                    ? options.workers
+                                    : std::max(1u, std::thread::hardware_concurrency());
+        SwarmStats result;
+        result.workers.resize(workers);
+        std::vector<CardinalitySketch> sketches(workers);
+        std::atomic<bool> stop{false};
+
+        auto worker = [&](std::size_t w) {
+            auto &stats = result.workers[w];
+            auto &sketch = sketches[w];
+            std::mt19937_64 rng(mix64(options.seed + w));
+            std::vector<std::uint64_t> bits(std::max<std::size_t>(1, options.bitstate_bits / 64));
+            std::vector<Frame> stack;
+            std::size_t steps = 0;
+            const auto out_of_time = [&] {
+                return stop.load(std::memory_order_relaxed) ||
+                       (++steps % 1024 == 0 && std::chrono::steady_clock::now() >= deadline);
+            };
+
+            while (!stop.load(std::memory_order_relaxed) && std::chrono::steady_clock::now() < deadline) {
+                ++stats.searches;
+                std::fill(bits.begin(), bits.end(), 0);
+                std::size_t set_bits = 0;
+                const std::uint64_t salt = rng();
+                const std::size_t depth_bound = options.max_depth / 2 + rng() % (options.max_depth / 2 + 1);
+                // Every search explores under its own salted hash, but the
+                // sketch sees the unsalted one so workers' counts can be merged.
+                auto enter = [&](const StateType &state) {
+                    const auto base = static_cast<std::uint64_t>(m_hash(state));
+                    if (!visit(bits, mix64(base ^ salt), options.hash_functions, set_bits)) {
+                        return false;
+                    }
+                    ++stats.states;
+                    sketch.add(mix64(base));
+                    if constexpr (std::is_convertible_v<std::invoke_result_t<Visitor &, const StateType &>, bool>) {
+                        if (!on_state(state)) {
+                            stop.store(true, std::memory_order_relaxed);
+                        }
+                    } else {
+                        on_state(state);
+                    }
+                    return true;
+                };
+
+                auto roots = m_gen.initial_states();
+                std::shuffle(roots.begin(), roots.end(), rng);
+                for (const auto &root: roots) {
+                    if (!enter(root)) {
+                        continue;
+                    }
+                    stack.clear();
+                    stack.emplace_back();
+                    m_gen.successors(root, [&](const StateType &succ) { stack.back().successors.push_back(succ); });
+                    std::shuffle(stack.back().successors.begin(), stack.back().successors.end(), rng);
+                    while (!stack.empty() && !out_of_time()) {
+                        stats.max_depth = std::max(stats.max_depth, stack.size());
+                        auto &top = stack.back();
+                        if (top.next == top.successors.size()) {
+                            stack.pop_back();
+                            continue;
+                        }
+                        const StateType state = std::move(top.successors[top.next++]);
+                        ++stats.transitions;
+                        if (!enter(state) || stack.size() >= depth_bound) {
+                            continue;
+                        }
+                        Frame frame;
+                        m_gen.successors(state, [&](const StateType &succ) { frame.successors.push_back(succ); });
+                        std::shuffle(frame.successors.begin(), frame.successors.end(), rng);
+                        stack.push_back(std::move(frame));
+                    }
+                }
+                stats.fill = static_cast<double>(set_bits) / static_cast<double>(bits.size() * 64);
+            }
+        };
+
+        {
+            std::vector<std::jthread> threads;
+            threads.reserve(workers);
+            for (std::size_t w = 0; w < workers; ++w) {
+                threads.emplace_back(worker, w);
+            }
+        }
+        for (std::size_t w = 1; w < workers; ++w) {
+            sketches[0].merge(sketches[w]);
+        }
+        result.estimated_states = sketches[0].estimate();
+        result.complete = !stop.load();
+        return result;
+    }
+
+    SwarmStats explore(const SwarmOptions &options) const {
+        return explore(options, [](const StateType &) {});
+    }
+};
+
+/// A model of concurrent actions over a fixed alphabet [0, num_actions()).
+/// independent(a, b) must be a valid independence relation: whenever a is
+/// enabled, executing b neither enables nor disables a, and a and b commute.
+/// Actions whose execution may change a proposition of interest are visible().
+template<typename M>
+concept PartialOrderModel = requires(const M &model, const typename M::StateType &state, std::size_t action) {
+    typename M::StateType;
+    { model.initial_states() } -> std::convertible_to<std::vector<typename M::StateType>>;
+    { model.num_actions() } -> std::convertible_to<std::size_t>;
+    { model.enabled(state, action) } -> std::convertible_to<bool>;
+    { model.execute(state, action) } -> std::convertible_to<typename M::StateType>;
+    { model.independent(action, action) } -> std::convertible_to<bool>;
+    { model.visible(action) } -> std::convertible_to<bool>;
+};
+
+
+struct PartialOrderReport {
+    ExplorationStats full;
+    ExplorationStats reduced;
+
+    [[nodiscard]] std::size_t states_saved() const noexcept {
+        return full.states - reduced.states;
+    }
+
+    [[nodiscard]] std::size_t transitions_saved() const noexcept {
+        return full.transitions - reduced.transitions;
+    }
+};
+
+
+/// Depth-first exploration with ample-set partial-order reduction.
+///
+/// The ample set of a state is the enabled part of a set of actions closed
+/// under dependency over the whole alphabet (C1), is either all enabled
+/// actions or only invisible ones (C2), and falls back to full expansion when
+/// it would close a cycle on the DFS stack (C3). Among the seeds, the
+/// smallest qualifying ample set is taken.
+template<PartialOrderModel Model, typename Hash = std::hash<typename Model::StateType>>
+class PartialOrderExplorer {
+
+public:
+    using StateType = typename Model::StateType;
+
+private:
+    const Model &m_model;
+    Hash m_hash;
+    std::vector<std::vector<std::size_t>> m_dependents;
+
+    /// Visited-table payload: DFS order index shifted left, low bit = on stack.
+    using Entry = std::uint64_t;
+
+    /// DFS stack entry; Key is the state's visited-table key.
+    template<typename Key>
+    struct Frame {
+        Key key;
+        std::size_t index;
+        std::vector<StateType> successors;
+        std::size_t next = 0;
+    };
+
+    [[nodiscard]] std::vector<std::size_t> enabled_actions(const StateType &state) const {
+        std::vector<std::size_t> enabled;
+        for (std::size_t a = 0; a < m_dependents.size(); ++a) {
+            if (m_model.enabled(state, a)) {
+                enabled.push_back(a);
+            }
+        }
+        return enabled;
+    }
+
+    /// Smallest ample set satisfying C1 and C2, or all of enabled.
+    [[nodiscard]] std::vector<std::size_t> ample_set(const StateType &state, const std::vector<std::size_t> &enabled) const {
+        std::vector<std::size_t> best = enabled;
+        std::vector<char> in_closure(m_dependents.size());
+        std::vector<std::size_t> work;
+        for (auto seed: enabled) {
+            if (m_model.visible(seed)) {
+                continue;
+            }
+            std::fill(in_closure.begin(), in_closure.end(), 0);
+            work.assign(1, seed);
+            in_closure[seed] = 1;
+            std::vector<std::size_t> ample;
+            bool ok = true;
+            while (!work.empty() && ok) {
+                const auto a = work.back();
+                work.pop_back();
+                if (m_model.enabled(state, a)) {
+                    if (m_model.visible(a) || ample.size() + 1 >= best.size()) {
+                        ok = false;
+                        break;
+                    }
+                    ample.push_back(a);
+                }
+                for (auto b: m_dependents[a]) {
+                    if (!in_closure[b]) {
+                        in_closure[b] = 1;
+                        work.push_back(b);
+                    }
+                }
+            }
+            if (ok) {
+                best = std::move(ample);
+            }
+        }
+        return best;
+    }
+
+    /// With exact set, the visited table is keyed on full states, so
+    /// colliding fingerprints cannot merge two states; otherwise it holds
+    /// fingerprints only.
+    template<bool exact, typename OnState, typename OnTransition>
+    ExplorationStats dfs(bool reduce, OnState &&on_state, OnTransition &&on_transition) const {
+        using Key = std::conditional_t<exact, StateType, std::uint64_t>;
+        using Table = std::conditional_t<exact, std::unordered_map<StateType, Entry, Hash>, FingerprintTable<Entry>>;
+        ExplorationStats stats;
+        Table visited = [&] {
+            if constexpr (exact) {
+                return Table(16, m_hash);
+            } else {
+                return Table();
+            }
+        }();
+        std::vector<Frame<Key>> stack;
+
+        auto key = [&](const StateType &state) -> Key {
+            if constexpr (exact) {
+                return state;
+            } else {
+                return fingerprint(state);
+            }
+        };
+        auto find = [&](const Key &k) -> const Entry * {
+            if constexpr (exact) {
+                const auto it = visited.find(k);
+                return it == visited.end() ? nullptr : &it->second;
+            } else {
+                return visited.find(k);
+            }
+        };
+        auto emplace = [&](const Key &k, Entry entry) -> std::pair<Entry &, bool> {
+            if constexpr (exact) {
+                const auto [it, inserted] = visited.try_emplace(k, entry);
+                return {it->second, inserted};
+            } else {
+                return visited.try_emplace(k, entry);
+            }
+        };
+
+        auto expand = [&](const StateType &state) {
+            const auto enabled = enabled_actions(state);
+            auto chosen = reduce ? ample_set(state, enabled) : enabled;
+            std::vector<StateType> succ;
+            succ.reserve(chosen.size());
+            for (auto a: chosen) {
+                succ.push_back(m_model.execute(state, a));
+            }
+            if (chosen.size() < enabled.size()) {
+                // C3: a reduced expansion must not close a cycle on the stack.
+                const bool closes_cycle = std::any_of(succ.begin(), succ.end(), [&](const StateType &s) {
+                    const auto *entry = find(key(s));
+                    return entry && (*entry & 1u);
+                });
+                if (closes_cycle) {
+                    succ.clear();
+                    for (auto a: enabled) {
+                        succ.push_back(m_model.execute(state, a));
+                    }
+                }
+            }
+            return succ;
+        };
+
+        // Returns the index of state and pushes it if it is new.
+        auto visit = [&](const StateType &state) -> std::size_t {
+            auto k = key(state);
+            const auto [entry, inserted] = emplace(k, (Entry{stats.states} << 1) | 1u);
+            if (!inserted) {
+                return static_cast<std::size_t>(entry >> 1);
+            }
+            const auto index = stats.states++;
+            on_state(index, state);
+            stack.push_back({std::move(k), index, {}});
+            stack.back().successors = expand(state);
+            stats.max_frontier = std::max(stats.max_frontier, stack.size());
+            return index;
+        };
+
+        for (const auto &init: m_model.initial_states()) {
+            visit(init);
+            while (!stack.empty()) {
+                auto &top = stack.back();
+                if (top.next == top.successors.size()) {
+                    emplace(top.key, 0).first &= ~Entry{1};
+                    stack.pop_back();
+                    continue;
+                }
+                const auto from = top.index;
+                const StateType succ = top.successors[top.next++];
+                ++stats.transitions;
+                on_transition(from, visit(succ));
+            }
+        }
+        if constexpr (exact) {
+            // Node-based map: key, entry and two pointers per node, plus buckets.
+            stats.visited_bytes = visited.size() * (sizeof(StateType) + sizeof(Entry) + 2 * sizeof(void *)) +
+                                  visited.bucket_count() * sizeof(void *);
+        } else {
+            stats.visited_bytes = visited.memory_bytes();
+        }
+        return stats;
+    }
+
+public:
+    explicit PartialOrderExplorer(const Model &model, Hash hash = {})
+            : m_model(model), m_hash(std::move(hash)), m_dependents(model.num_actions()) {
+        for (std::size_t a = 0; a < m_dependents.size(); ++a) {
+            for (std::size_t b = 0; b < m_dependents.size(); ++b) {
+                if (a == b || !m_model.independent(a, b)) {
+                    m_dependents[a].push_back(b);
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] std::uint64_t fingerprint(const StateType &state) const {
+        return mix64(static_cast<std::uint64_t>(m_hash(state)));
+    }
+
+    /// Explores with (reduce = true) or without partial-order reduction.
+    template<std::invocable<const StateType &> Visitor>
+    ExplorationStats explore(Visitor &&on_state, bool reduce = true) const {
+        return dfs<false>(reduce, [&](std::size_t, const StateType &state) { on_state(state); },
+                   [](std::size_t, std::size_t) {});
+    }
+
+    ExplorationStats explore(bool reduce = true) const {
+        return explore([](const StateType &) {}, reduce);
+    }
+
+    /// Runs the full and the reduced exploration and reports the savings.
+    [[nodiscard]] PartialOrderReport report() const {
+        return {explore(false), explore(true)};
+    }
+
+    /// Materializes the reduced state space; states are numbered in DFS order.
+    /// Visited states are keyed on the states themselves, so this needs ==
+    /// on StateType but never merges distinct states.
+    auto build_frame(bool reduce = true, ExplorationStats *stats = nullptr) const
+    requires std::equality_comparable<StateType> && requires(const Model &model, const StateType &s) {
+        { model.label(s) } -> std::convertible_to<typename Model::LabelType>;
+    } {
+        KripkeFrame<StateType, typename Model::LabelType> frame;
+        std::vector<std::pair<std::size_t, std::size_t>> edges;
+        const auto local = dfs<true>(reduce, [&](std::size_t, const StateType &state) {
+            frame.add_state(state, m_model.label(state));
+        }, [&](std::size_t from, std::size_t to) {
+            edges.emplace_back(from, to);
+        });
+        for (const auto &[from, to]: edges) {
+            frame.add_transition(from, to);
+        }
+        if (stats) {
+            *stats = local;
+        }
+        return frame;
+    }
+};
+
+enum class Composition {
+    /// All components step together.
+    synchronous,
+    /// One component steps at a time while the others stay put.
+    interleaving,
+};
+
+
+/// Reachable product of frames with proposition labels. A product state is
+/// the tuple of component state indices, encoded mixed-radix in one
+/// std::uint64_t (component 0 in the lowest digit), and is labelled with the
+/// union of its components' labels.
+///
+/// Components synchronize on the propositions in `synchronized`: product
+/// states only combine component states that agree on them. In the
+/// interleaving product, a step that changes a synchronized proposition
+/// therefore drags along every component that now disagrees, each to a
+/// successor that agrees again; if one of them has none, the step is blocked.
+///
+/// FrameProduct is a LabelledStateGenerator, so any explorer can expand it
+/// lazily. build() expands it level by level instead, generating a level's
+/// successors in parallel and appending them straight into CSR.
+template<KripkeFrameLike Frame> requires Frame::has_proposition_labels
+class FrameProduct {
+
+public:
+    using StateType = std::uint64_t;
+    using LabelType = typename Frame::LabelType;
+    using FrameType = KripkeFrame<StateType, LabelType>;
+
+private:
+    struct Component {
+        const Frame *frame;
+        std::vector<std::size_t> initial;
+        std::vector<LabelType> labels;
+        std::uint64_t radix;
+        std::uint64_t stride;
+    };
+
+    std::vector<Component> m_components;
+    Composition m_composition;
+    LabelType m_synchronized;
+    /// Product of all radices, i.e. the stride of the next component.
+    std::uint64_t m_space = 1;
+
+    [[nodiscard]] LabelType shared(const Component &c, std::size_t v) const {
+        return c.labels[v] & m_synchronized;
+    }
+
+    [[nodiscard]] StateType with(StateType code, std::size_t i, std::size_t v) const {
+        const auto &c = m_components[i];
+        return code - component_state(code, i) * c.stride + v * c.stride;
+    }
+
+    /// Completes a step for components j.. of source: components other than
+    /// mover either keep a state whose synchronized propositions equal value
+    /// (interleaving only) or move to a successor that has them.
+    template<typename Emit>
+    void extend(std::size_t j, std::size_t mover, StateType source, StateType code, const LabelType &value,
+                Emit &emit) const {
+        if (j == m_components.size()) {
+            emit(code);
+            return;
+        }
+        if (j == mover) {
+            extend(j + 1, mover, source, code, value, emit);
+            return;
+        }
+        const auto &c = m_components[j];
+        const auto v = component_state(source, j);
+        if (m_composition == Composition::interleaving && shared(c, v) == value) {
+            extend(j + 1, mover, source, code, value, emit);
+            return;
+        }
+        for (auto w: c.frame->successors(v)) {
+            if (shared(c, w) == value) {
+                extend(j + 1, mover, source, with(code, j, w), value, emit);
+            }
+        }
+    }
+
+    void combine_initial(std::size_t j, StateType code, const LabelType &value, std::vector<StateType> &out) const {
+        if (j == m_components.size()) {
+            out.push_back(code);
+            return;
+        }
+        const auto &c = m_components[j];
+        for (auto v: c.initial) {
+            if (j == 0 || shared(c, v) == value) {
+                combine_initial(j + 1, code + v * c.stride, j == 0 ? shared(c, v) : value, out);
+            }
+        }
+    }
+
+public:
+    explicit FrameProduct(Composition composition, LabelType synchronized = {})
+            : m_composition(composition), m_synchronized(synchronized) {}
+
+    /// Adds a component starting in any of `initial`. The frame must outlive
+    /// the product. Returns false, leaving the product unchanged, if the frame
+    /// is empty, an initial state is out of range, or the tuple encoding would
+    /// no longer fit in 64 bits.
+    bool add_component(const Frame &frame, std::vector<std::size_t> initial = {0}) {
+        const std::uint64_t radix = frame.num_states();
+        if (radix == 0 || m_space > std::numeric_limits<std::uint64_t>::max() / radix) {
+            return false;
+        }
+        for (auto v: initial) {
+            if (v >= radix) {
+                return false;
+            }
+        }
+        std::vector<LabelType> labels(radix);
+        parallel_for(0, radix, [&](std::size_t v) {
+            labels[v] = frame.get_label(v);
+        });
+        m_components.push_back({&frame, std::move(initial), std::move(labels), radix, m_space});
+        m_space *= radix;
+        return true;
+    }
+
+    [[nodiscard]] std::size_t num_components() const noexcept {
+        return m_components.size();
+    }
+
+    [[nodiscard]] std::size_t component_state(StateType state, std::size_t i) const {
+        const auto &c = m_components[i];
+        return static_cast<std::size_t>(state / c.stride % c.radix);
+    }
+
+    [[nodiscard]] std::vector<StateType> initial_states() const {
+        std::vector<StateType> result;
+        if (!m_components.empty()) {
+            combine_initial(0, 0, {}, result);
+        }
+        return result;
+    }
+
+    /// Reports every successor of state. In the interleaving product a
+    /// successor reachable by more than one step is reported once per step.
+    template<typename Emit>
+    void successors(const StateType &state, Emit &&emit) const {
+        const std::size_t movers = m_composition == Composition::synchronous
+                                   ? std::min<std::size_t>(1, m_components.size())
+                                   : m_components.size();
+        for (std::size_t i = 0; i < movers; ++i) {
+            const auto &c = m_components[i];
+            for (auto w: c.frame->successors(component_state(state, i))) {
+                extend(0, i, state, with(state, i, w), shared(c, w), emit);
+            }
+        }
+    }
+
+    [[nodiscard]] LabelType label(const StateType &state) const {
+        LabelType result;
+        for (std::size_t i = 0; i < m_components.size(); ++i) {
+            result |= m_components[i].labels[component_state(state, i)];
+        }
+        return result;
+    }
+
+    /// Materializes the reachable product in BFS order with sorted,
+    /// duplicate-free successor lists. Once max_states states are known,
+    /// transitions to further states are dropped and the result is incomplete.
+    [[nodiscard]] FrameType build(std::size_t max_states = std::numeric_limits<std::size_t>::max(),
+                                  ExplorationStats *stats = nullptr) const {
+        ExplorationStats local;
+        std::vector<StateType> codes;
+        // mix64 is a bijection and code + 1 is never 0, so these keys are
+        // exact: the fingerprint table cannot confuse two product states.
+        FingerprintTable<std::size_t> index;
+        const auto key = [](StateType code) { return mix64(code + 1); };
+        for (auto code: initial_states()) {
+            if (codes.size() < max_states && index.try_emplace(key(code), codes.size()).second) {
+                codes.push_back(code);
+            }
+        }
+
+        std::vector<std::size_t> offsets{0};
+        std::vector<std::size_t> targets;
+        std::vector<std::vector<StateType>> rows;
+        for (std::size_t begin = 0; begin < codes.size();) {
+            const auto end = codes.size();
+            local.max_frontier = std::max(local.max_frontier, end - begin);
+            // Successor generation dominates and is independent per state;
+            // numbering stays serial so the frame comes out in BFS order.
+            rows.assign(end - begin, {});
+            parallel_for(begin, end, [&](std::size_t v) {
+                auto &row = rows[v - begin];
+                successors(codes[v], [&](StateType succ) { row.push_back(succ); });
+                std::sort(row.begin(), row.end());
+                row.erase(std::unique(row.begin(), row.end()), row.end());
+            }, 64);
+            for (auto &row: rows) {
+                const auto first = targets.size();
+                for (auto code: row) {
+                    if (codes.size() < max_states) {
+                        const auto [target, fresh] = index.try_emplace(key(code), codes.size());
+                        targets.push_back(target);
+                        if (fresh) {
+                            codes.push_back(code);
+                        }
+                    } else if (const auto *target = index.find(key(code))) {
+                        targets.push_back(*target);
+                    } else {
+                        local.complete = false;
+                    }
+                }
+                std::sort(targets.begin() + static_cast<std::ptrdiff_t>(first), targets.end());
+                offsets.push_back(targets.size());
+                row = {};
+            }
+            begin = end;
+        }
+
+        std::vector<LabelType> labels(codes.size());
+        parallel_for(0, codes.size(), [&](std::size_t v) {
+            labels[v] = label(codes[v]);
+        });
+        KripkeFrameBuilder<StateType, LabelType> builder;
+        for (std::size_t v = 0; v < codes.size(); ++v) {
+            (void) builder.add_state(codes[v], labels[v]);
+        }
+        local.states = codes.size();
+        local.transitions = targets.size();
+        local.visited_bytes = index.memory_bytes() + codes.capacity() * sizeof(StateType);
+        if (stats) {
+            *stats = local;
+        }
+        return std::move(builder).build_csr(std::move(offsets), std::move(targets));
+    }
+};
+
+struct SccDecomposition {
+    /// Component of every state; components are numbered in reverse
+    /// topological order, so every edge u -> v has component[v] <= component[u].
+    std::vector<std::size_t> component;
+    std::size_t count = 0;
+};
+
+/// Iterative Tarjan over n vertices. successors(v, emit) reports every
+/// successor w of v by calling emit(w).
+template<typename Successors>
+SccDecomposition strongly_connected_components(std::size_t n, Successors &&successors) {
+    constexpr auto unvisited = static_cast<std::size_t>(-1);
+    SccDecomposition result;
+    result.component.assign(n, unvisited);
+    std::vector<std::size_t> index(n, unvisited), lowlink(n, 0), stack;
+    std::vector<std::pair<std::size_t, std::vector<std::size_t>>> call;
+    std::size_t counter = 0;
+
+    for (std::size_t root = 0; root < n; ++root) {
+        if (index[root] != unvisited) {
+            continue;
+        }
+        auto enter = [&](std::size_t v) {
+            index[v] = lowlink[v] = counter++;
+            stack.push_back(v);
+            std::vector<std::size_t> succ;
+            successors(v, [&](std::size_t w) { succ.push_back(w); });
+            std::reverse(succ.begin(), succ.end());
+            call.emplace_back(v, std::move(succ));
+        };
+        enter(root);
+        while (!call.empty()) {
+            auto &[v, pending] = call.back();
+            if (!pending.empty()) {
+                const auto w = pending.back();
+                pending.pop_back();
+                if (index[w] == unvisited) {
+                    enter(w);
+                } else if (result.component[w] == unvisited) {
+                    lowlink[v] = std::min(lowlink[v], index[w]);
+                }
+                continue;
+            }
+            const auto done = v;
+            call.pop_back();
+            if (lowlink[done] == index[done]) {
+                std::size_t w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    result.component[w] = result.count;
+                } while (w != done);
+                ++result.count;
+            }
+            if (!call.empty()) {
+                auto &parent = call.back().first;
+                lowlink[parent] = std::min(lowlink[parent], lowlink[done]);
+            }
+        }
+    }
+    return result;
+}
+
+template<KripkeFrameLike Frame>
+SccDecomposition strongly_connected_components(const Frame &frame) {
+    return strongly_connected_components(frame.num_states(), [&](std::size_t v, auto &&emit) {
+        for (auto w: frame.successors(v)) {
+            emit(w);
+        }
+    });
+}
+
+
+/// Breadth-first distances from source; unreachable states get StateSet::npos.
+template<KripkeFrameLike Frame>
+std::vector<std::size_t> bfs_distances(const Frame &frame, std::size_t source) {
+    std::vector<std::size_t> distance(frame.num_states(), StateSet::npos);
+    std::vector<std::size_t> queue{source};
+    distance[source] = 0;
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        const auto v = queue[head];
+        for (auto w: frame.successors(v)) {
+            if (distance[w] == StateSet::npos) {
+                distance[w] = distance[v] + 1;
+                queue.push_back(w);
+            }
+        }
+    }
+    return distance;
+}
+
+enum class Bisimulation {
+    /// Strong bisimulation: equal labels and matching single steps.
+    strong,
+    /// Divergence-sensitive stuttering bisimulation: steps that stay inside
+    /// a class are invisible, but a state that can stutter forever is never
+    /// merged with one that cannot, which preserves CTL without next (CTL-X).
+    stutter
+};
+
+template<typename State, typename Label>
+struct BisimulationQuotient {
+    KripkeFrame<State, Label> frame;
+    /// Quotient state (block) of every original state.
+    std::vector<std::size_t> block_of;
+};
+
+
+/// Partition of [0, n) kept as one array ordered by block, so a block can
+/// be split in place by moving its marked members to the back.
+class RefinablePartition {
+
+private:
+    std::vector<std::size_t> m_elements;
+    std::vector<std::size_t> m_position;
+    std::vector<std::size_t> m_block_of;
+    std::vector<std::size_t> m_begin;
+    std::vector<std::size_t> m_end;
+    std::vector<std::size_t> m_marked;
+
+public:
+    /// Starts from the partition given by an initial block per element.
+    explicit RefinablePartition(const std::vector<std::size_t> &initial) : m_position(initial.size()), m_block_of(initial) {
+        const std::size_t blocks = initial.empty() ? 0 : *std::max_element(initial.begin(), initial.end()) + 1;
+        m_begin.assign(blocks, 0);
+        m_end.assign(blocks, 0);
+        m_marked.assign(blocks, 0);
+        for (auto b: initial) {
+            ++m_end[b];
+        }
+        std::size_t offset = 0;
+        for (std::size_t b = 0; b < blocks; ++b) {
+            m_begin[b] = offset;
+            offset += m_end[b];
+            m_end[b] = m_begin[b];
+        }
+        m_elements.resize(initial.size());
+        for (std::size_t v = 0; v < initial.size(); ++v) {
+            m_position[v] = m_end[initial[v]]++;
+            m_elements[m_position[v]] = v;
+        }
+    }
+
+    [[nodiscard]] std::size_t num_blocks() const noexcept {
+        return m_begin.size();
+    }
+
+    [[nodiscard]] std::size_t block_of(std::size_t v) const {
+        return m_block_of[v];
+    }
+
+    [[nodiscard]] auto block_of() const -> const std::vector<std::size_t> & {
+        return m_block_of;
+    }
+
+    [[nodiscard]] auto members(std::size_t block) const -> std::span<const std::size_t> {
+        return {m_elements.data() + m_begin[block], m_elements.data() + m_end[block]};
+    }
+
+    /// Marks v; returns true if this was the first mark in its block.
+    bool mark(std::size_t v) {
+        const auto b = m_block_of[v];
+        const auto boundary = m_end[b] - m_marked[b];
+        if (m_position[v] >= boundary) {
+            return false;
+        }
+        const auto last = boundary - 1;
+        const auto other = m_elements[last];
+        std::swap(m_elements[m_position[v]], m_elements[last]);
+        m_position[other] = m_position[v];
+        m_position[v] = last;
+        return m_marked[b]++ == 0;
+    }
+
+    /// Moves the marked members of block into a new block and clears the
+    /// marks. Returns the new block, or npos if nothing was split off.
+    std::size_t split(std::size_t block) {
+        const auto marked = std::exchange(m_marked[block], 0);
+        if (marked == 0 || marked == m_end[block] - m_begin[block]) {
+            return StateSet::npos;
+        }
+        const auto fresh = m_begin.size();
+        m_begin.push_back(m_end[block] - marked);
+        m_end.push_back(m_end[block]);
+        m_marked.push_back(0);
+        m_end[block] -= marked;
+        for (auto pos = m_begin[fresh]; pos < m_end[fresh]; ++pos) {
+            m_block_of[m_elements[pos]] = fresh;
+        }
+        return fresh;
+    }
+};
+
+
+/// Computes the coarsest strong or stuttering bisimulation of frame and
+/// returns the quotient frame together with the state-to-block map. Each
+/// block is represented by its lowest-numbered state.
+template<KripkeFrameLike Frame>
+auto minimize(const Frame &frame, Bisimulation kind = Bisimulation::strong)
+-> BisimulationQuotient<typename Frame::StateType, typename Frame::LabelType> {
+    using Label = typename Frame::LabelType;
+    const std::size_t n = frame.num_states();
+
+    // Initial partition: states with equal labels.
+    std::vector<std::size_t> initial(n);
+    {
+        std::unordered_map<Label, std::size_t> label_block;
+        for (std::size_t v = 0; v < n; ++v) {
+            initial[v] = label_block.try_emplace(frame.get_label(v), label_block.size()).first->second;
+        }
+    }
+
+    std::vector<std::size_t> block_of;
+    std::vector<char> divergent(n, 0);
+    if (kind == Bisimulation::strong) {
+        // Paige-Tarjan. Besides the partition P of states there is a coarser
+        // partition Q whose blocks are unions of P blocks, and P is stable
+        // with respect to every Q block. Each edge s -> t points at the
+        // counter count(s, X) of edges from s into the Q block X holding t.
+        // Splitting a compound Q block S moves out its smaller P block B,
+        // and one pass over the edges into B splits P by "reaches B" and by
+        // "reaches S \ B" (count(s, B) < count(s, S)), so every state is in
+        // a splitter O(log n) times and refinement takes O(m log n).
+        std::vector<std::size_t> offsets(n + 1, 0);
+        for (std::size_t v = 0; v < n; ++v) {
+            offsets[v + 1] = offsets[v] + frame.successors(v).size();
+        }
+        const std::size_t m = offsets[n];
+        std::vector<std::size_t> source(m), pred_offsets(n + 1, 0), pred_edges(m);
+        for (std::size_t v = 0; v < n; ++v) {
+            auto e = offsets[v];
+            for (auto w: frame.successors(v)) {
+                source[e++] = v;
+                ++pred_offsets[w + 1];
+            }
+        }
+        std::partial_sum(pred_offsets.begin(), pred_offsets.end(), pred_offsets.begin());
+        {
+            auto next = pred_offsets;
+            for (std::size_t v = 0; v < n; ++v) {
+                auto e = offsets[v];
+                for (auto w: frame.successors(v)) {
+                    pred_edges[next[w]++] = e++;
+                }
+            }
+        }
+
+        // Q starts as the single block of all states, so P must first be
+        // stable with respect to it: split labels by "has a successor".
+        std::vector<std::size_t> refined(n);
+        {
+            std::map<std::pair<std::size_t, bool>, std::size_t> blocks;
+            for (std::size_t v = 0; v < n; ++v) {
+                refined[v] = blocks.try_emplace({initial[v], offsets[v + 1] > offsets[v]}, blocks.size()).first->second;
+            }
+        }
+        RefinablePartition partition(refined);
+        // Counter v starts as count(v, all states); every edge points at its source's.
+        std::vector<std::size_t> count(n);
+        for (std::size_t v = 0; v < n; ++v) {
+            count[v] = offsets[v + 1] - offsets[v];
+        }
+        std::vector<std::size_t> edge_count(source);
+
+        // Q blocks as lists of P blocks, with each P block's place in its list.
+        std::vector<std::vector<std::size_t>> compound(1);
+        std::vector<std::size_t> compound_of(partition.num_blocks(), 0), slot(partition.num_blocks());
+        for (std::size_t b = 0; b < partition.num_blocks(); ++b) {
+            slot[b] = b;
+            compound[0].push_back(b);
+        }
+        std::vector<std::size_t> worklist;
+        std::vector<char> queued{0};
+        auto enqueue = [&](std::size_t x) {
+            if (compound[x].size() > 1 && !queued[x]) {
+                queued[x] = 1;
+                worklist.push_back(x);
+            }
+        };
+        enqueue(0);
+        auto split_marked = [&](std::vector<std::size_t> &touched) {
+            for (auto b: touched) {
+                const auto fresh = partition.split(b);
+                if (fresh == StateSet::npos) {
+                    continue;
+                }
+                const auto x = compound_of[b];
+                compound_of.push_back(x);
+                slot.push_back(compound[x].size());
+                compound[x].push_back(fresh);
+                enqueue(x);
+            }
+            touched.clear();
+        };
+
+        std::vector<std::size_t> splitter, sources, touched;
+        // Per source state of the current splitter: its count(s, B) and count(s, S) counters.
+        std::vector<std::size_t> to_b(n, StateSet::npos), to_s(n);
+        while (!worklist.empty()) {
+            const auto s_block = worklist.back();
+            worklist.pop_back();
+            queued[s_block] = 0;
+            auto &members = compound[s_block];
+            const auto b = partition.members(members[0]).size() <= partition.members(members[1]).size()
+                           ? members[0] : members[1];
+            members[slot[b]] = members.back();
+            slot[members.back()] = slot[b];
+            members.pop_back();
+            enqueue(s_block);
+            compound_of[b] = compound.size();
+            slot[b] = 0;
+            compound.push_back({b});
+            queued.push_back(0);
+
+            splitter.assign(partition.members(b).begin(), partition.members(b).end());
+            for (auto t: splitter) {
+                for (auto k = pred_offsets[t]; k < pred_offsets[t + 1]; ++k) {
+                    const auto e = pred_edges[k];
+                    const auto s = source[e];
+                    if (to_b[s] == StateSet::npos) {
+                        to_b[s] = count.size();
+                        count.push_back(0);
+                        to_s[s] = edge_count[e];
+                        sources.push_back(s);
+                    }
+                    ++count[to_b[s]];
+                }
+            }
+            for (auto s: sources) {
+                if (partition.mark(s)) {
+                    touched.push_back(partition.block_of(s));
+                }
+            }
+            split_marked(touched);
+            for (auto s: sources) {
+                if (count[to_b[s]] == count[to_s[s]] && partition.mark(s)) {
+                    touched.push_back(partition.block_of(s));
+                }
+            }
+            split_marked(touched);
+            for (auto t: splitter) {
+                for (auto k = pred_offsets[t]; k < pred_offsets[t + 1]; ++k) {
+                    const auto e = pred_edges[k];
+                    --count[edge_count[e]];
+                    edge_count[e] = to_b[source[e]];
+                }
+            }
+            for (auto s: sources) {
+                to_b[s] = StateSet::npos;
+            }
+            sources.clear();
+        }
+        block_of = partition.block_of();
+    } else {
+        // Groote-Vaandrager style signature refinement. States on a cycle of
+        // equally labelled transitions are stutter equivalent, so collapse
+        // those SCCs first; inert steps then form a DAG, and the components
+        // come out of Tarjan in an order where inert successors come first.
+        // A collapsed cycle lets its states stutter forever; it adds the
+        // marker `diverges` to their signature, which inert predecessors
+        // inherit, so divergent and non-divergent states end up apart.
+        constexpr auto diverges = StateSet::npos;
+        const auto scc = strongly_connected_components(n, [&](std::size_t v, auto &&emit) {
+            for (auto w: frame.successors(v)) {
+                if (initial[w] == initial[v]) {
+                    emit(w);
+                }
+            }
+        });
+        std::vector<std::vector<std::size_t>> comp_succ(scc.count);
+        std::vector<std::size_t> comp_block(scc.count);
+        std::vector<char> comp_cycle(scc.count, 0);
+        for (std::size_t v = 0; v < n; ++v) {
+            const auto c = scc.component[v];
+            comp_block[c] = initial[v];
+            for (auto w: frame.successors(v)) {
+                if (scc.component[w] != c) {
+                    comp_succ[c].push_back(scc.component[w]);
+                } else {
+                    comp_cycle[c] = 1;
+                }
+            }
+        }
+        for (auto &succ: comp_succ) {
+            std::sort(succ.begin(), succ.end());
+            succ.erase(std::unique(succ.begin(), succ.end()), succ.end());
+        }
+
+        std::size_t num_blocks = 0;
+        std::vector<std::vector<std::size_t>> signature(scc.count);
+        for (;;) {
+            for (std::size_t c = 0; c < scc.count; ++c) {
+                auto &sig = signature[c];
+                sig.clear();
+                if (comp_cycle[c]) {
+                    sig.push_back(diverges);
+                }
+                for (auto d: comp_succ[c]) {
+                    if (comp_block[d] == comp_block[c]) {
+                        sig.insert(sig.end(), signature[d].begin(), signature[d].end());
+                    } else {
+                        sig.push_back(comp_block[d]);
+                    }
+                }
+                std::sort(sig.begin(), sig.end());
+                sig.erase(std::unique(sig.begin(), sig.end()), sig.end());
+            }
+            std::map<std::pair<std::size_t, std::vector<std::size_t>>, std::size_t> blocks;
+            std::vector<std::size_t> refined(scc.count);
+            for (std::size_t c = 0; c < scc.count; ++c) {
+                refined[c] = blocks.try_emplace({comp_block[c], signature[c]}, blocks.size()).first->second;
+            }
+            comp_block = std::move(refined);
+            if (blocks.size() == num_blocks) {
+                break;
+            }
+            num_blocks = blocks.size();
+        }
+        block_of.resize(n);
+        for (std::size_t v = 0; v < n; ++v) {
+            const auto &sig = signature[scc.component[v]];
+            block_of[v] = comp_block[scc.component[v]];
+            divergent[v] = !sig.empty() && sig.back() == diverges;
+        }
+    }
+
+    // Renumber blocks by their lowest member and build the quotient.
+    BisimulationQuotient<typename Frame::StateType, Label> result;
+    std::vector<std::size_t> renumber(n, StateSet::npos);
+    result.block_of.resize(n);
+    for (std::size_t v = 0; v < n; ++v) {
+        auto &id = renumber[block_of[v]];
+        if (id == StateSet::npos) {
+            id = result.frame.num_states();
+            result.frame.add_state(frame.get_state(v), frame.get_label(v));
+        }
+        result.block_of[v] = id;
+    }
+    std::vector<std::vector<std::size_t>> edges(result.frame.num_states());
+    for (std::size_t v = 0; v < n; ++v) {
+        for (auto w: frame.successors(v)) {
+            const auto from = result.block_of[v];
+            const auto to = result.block_of[w];
+            // A stutter quotient keeps a self-loop only for divergent blocks,
+            // whose members all diverge.
+            if (from != to || kind == Bisimulation::strong || divergent[v]) {
+                edges[from].push_back(to);
+            }
+        }
+    }
+    for (std::size_t from = 0; from < edges.size(); ++from) {
+        std::sort(edges[from].begin(), edges[from].end());
+        edges[from].erase(std::unique(edges[from].begin(), edges[from].end()), edges[from].end());
+        for (auto to: edges[from]) {
+            result.frame.add_transition(from, to);
+        }
+    }
+    return result;
+}
+
+struct ReachabilityIndexOptions {
+    /// Condensations with at most this many components get a full bitset
+    /// transitive closure (components^2 / 8 bytes, constant-time queries).
+    std::size_t closure_limit = std::size_t{1} << 14;
+    /// Interval labelings kept for larger condensations (8 bytes per
+    /// component each); more labelings settle more queries without search.
+    /// Labels are 32-bit, so condensations with 2^32 or more components
+    /// get none and rely on the level-pruned search alone.
+    std::size_t labelings = 3;
+    std::uint64_t seed = 1;
+};
+
+
+/// Answers "can u reach v" for a fixed frame. States are collapsed to their
+/// SCCs, so queries run on the condensation DAG. Small DAGs store the
+/// transitive closure. Large ones use GRAIL-style interval labels: each
+/// labeling is a randomized DFS post-order, and u can only reach v if v's
+/// interval nests in u's in every labeling, so most negative queries are
+/// answered by comparisons. The remaining queries run a DFS that the labels
+/// and topological levels prune.
+class ReachabilityIndex {
+
+private:
+    std::vector<std::size_t> m_component;
+    std::size_t m_count = 0;
+    /// Condensation DAG in CSR form; components are numbered sinks first.
+    std::vector<std::size_t> m_offsets;
+    std::vector<std::size_t> m_targets;
+    /// Longest path to a sink; reachability strictly decreases it.
+    std::vector<std::size_t> m_level;
+    /// Closure rows, one StateSet over components per component, if used.
+    std::vector<StateSet> m_closure;
+    /// (low, post) per labeling and component, interleaved by component.
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> m_intervals;
+    std::size_t m_labelings = 0;
+
+    [[nodiscard]] bool may_reach(std::size_t c, std::size_t d) const noexcept {
+        if (m_level[c] <= m_level[d]) {
+            return false;
+        }
+        for (std::size_t i = 0; i < m_labelings; ++i) {
+            const auto &[low_c, post_c] = m_intervals[c * m_labelings + i];
+            const auto &[low_d, post_d] = m_intervals[d * m_labelings + i];
+            if (low_d < low_c || post_d > post_c) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void label(std::size_t slot, std::mt19937_64 &rng) {
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> intervals(m_count);
+        std::vector<std::size_t> roots(m_count);
+        std::iota(roots.begin(), roots.end(), 0);
+        std::shuffle(roots.begin(), roots.end(), rng);
+        std::vector<char> done(m_count, 0);
+        std::vector<std::pair<std::size_t, std::size_t>> stack;
+        std::vector<std::size_t> order(m_targets.size());
+        std::iota(order.begin(), order.end(), 0);
+        // Randomize child order once per labeling by shuffling every adjacency slice.
+        for (std::size_t c = 0; c < m_count; ++c) {
+            std::shuffle(order.begin() + static_cast<std::ptrdiff_t>(m_offsets[c]),
+                         order.begin() + static_cast<std::ptrdiff_t>(m_offsets[c + 1]), rng);
+        }
+        std::uint32_t post = 0;
+        for (auto root: roots) {
+            if (done[root]) {
+                continue;
+            }
+            done[root] = 1;
+            intervals[root].first = std::numeric_limits<std::uint32_t>::max();
+            stack.emplace_back(root, m_offsets[root]);
+            while (!stack.empty()) {
+                auto &[c, next] = stack.back();
+                if (next < m_offsets[c + 1]) {
+                    const auto d = m_targets[order[next++]];
+                    if (!done[d]) {
+                        done[d] = 1;
+                        intervals[d].first = std::numeric_limits<std::uint32_t>::max();
+                        stack.emplace_back(d, m_offsets[d]);
+                    }
+                    continue;
+                }
+                const auto finished = c;
+                stack.pop_back();
+                auto &[low, rank] = intervals[finished];
+                rank = post++;
+                low = std::min(low, rank);
+                for (auto k = m_offsets[finished]; k < m_offsets[finished + 1]; ++k) {
+                    low = std::min(low, intervals[m_targets[k]].first);
+                }
+            }
+        }
+        for (std::size_t c = 0; c < m_count; ++c) {
+            m_intervals[c * m_labelings + slot] = intervals[c];
+        }
+    }
+
+public:
+    template<KripkeFrameLike Frame>
+    explicit ReachabilityIndex(const Frame &frame, const ReachabilityIndexOptions &options = {}) {
+        auto scc = strongly_connected_components(frame);
+        m_component = std::move(scc.component);
+        m_count = scc.count;
+
+        std::vector<std::vector<std::size_t>> dag(m_count);
+        for (std::size_t v = 0; v < frame.num_states(); ++v) {
+            for (auto w: frame.successors(v)) {
+                if (m_component[w] != m_component[v]) {
+                    dag[m_component[v]].push_back(m_component[w]);
+                }
+            }
+        }
+        m_offsets.assign(m_count + 1, 0);
+        m_level.assign(m_count, 0);
+        for (std::size_t c = 0; c < m_count; ++c) {
+            auto &succ = dag[c];
+            std::sort(succ.begin(), succ.end());
+            succ.erase(std::unique(succ.begin(), succ.end()), succ.end());
+            m_offsets[c + 1] = m_offsets[c] + succ.size();
+            // Successors have smaller numbers, so their levels are final.
+            for (auto d: succ) {
+                m_level[c] = std::max(m_level[c], m_level[d] + 1);
+            }
+        }
+        m_targets.reserve(m_offsets[m_count]);
+        for (auto &succ: dag) {
+            m_targets.insert(m_targets.end(), succ.begin(), succ.end());
+            succ = {};
+        }
+
+        if (m_count <= options.closure_limit) {
+            m_closure.reserve(m_count);
+            for (std::size_t c = 0; c < m_count; ++c) {
+                StateSet row(m_count);
+                row.set(c);
+                for (auto k = m_offsets[c]; k < m_offsets[c + 1]; ++k) {
+                    row |= m_closure[m_targets[k]];
+                }
+                m_closure.push_back(std::move(row));
+            }
+            return;
+        }
+        if (m_count > std::numeric_limits<std::uint32_t>::max()) {
+            return;
+        }
+        std::mt19937_64 rng(options.seed);
+        m_labelings = options.labelings;
+        m_intervals.resize(m_count * m_labelings);
+        for (std::size_t i = 0; i < m_labelings; ++i) {
+            label(i, rng);
+        }
+    }
+
+    [[nodiscard]] std::size_t num_components() const noexcept {
+        return m_count;
+    }
+
+    [[nodiscard]] std::size_t component(std::size_t state) const {
+        return m_component[state];
+    }
+
+    [[nodiscard]] bool uses_closure() const noexcept {
+        return !m_closure.empty() || m_count == 0;
+    }
+
+    [[nodiscard]] std::size_t memory_bytes() const noexcept {
+        std::size_t bytes = (m_component.size() + m_offsets.size() + m_targets.size() + m_level.size()) * sizeof(std::size_t) +
+                            m_intervals.size() * sizeof(m_intervals[0]);
+        for (const auto &row: m_closure) {
+            bytes += row.words().size() * 8;
+        }
+        return bytes;
+    }
+
+    /// Whether a path (possibly empty) leads from state u to state v. Safe
+    /// to call concurrently.
+    [[nodiscard]] bool reaches(std::size_t u, std::size_t v) const {
+        const auto c = m_component[u];
+        const auto d = m_component[v];
+        if (c == d) {
+            return true;
+        }
+        if (!m_closure.empty()) {
+            return m_closure[c].test(d);
+        }
+        if (!may_reach(c, d)) {
+            return false;
+        }
+        // Pruned DFS; visited marks are per-thread stamps so queries do not
+        // need to clear anything.
+        thread_local std::vector<std::uint64_t> stamp;
+        thread_local std::uint64_t current = 0;
+        thread_local std::vector<std::size_t> stack;
+        if (stamp.size() < m_count) {
+            stamp.assign(m_count, 0);
+            current = 0;
+        }
+        ++current;
+        stack.assign(1, c);
+        stamp[c] = current;
+        while (!stack.empty()) {
+            const auto x = stack.back();
+            stack.pop_back();
+            for (auto k = m_offsets[x]; k < m_offsets[x + 1]; ++k) {
+                const auto y = m_targets[k];
+                if (y == d) {
+                    return true;
+                }
+                if (stamp[y] != current && may_reach(y, d)) {
+                    stamp[y] = current;
+                    stack.push_back(y);
+                }
+            }
+        }
+        return false;
+    }
+};
+
+/// A path through a frame as state indices: prefix followed, for infinite
+/// (lasso) paths, by a cycle whose last state has a transition back to cycle[0].
+struct Trace {
+    std::vector<std::size_t> prefix;
+    std::vector<std::size_t> cycle;
+
+    [[nodiscard]] bool is_lasso() const noexcept {
+        return !cycle.empty();
+    }
+
+    [[nodiscard]] std::size_t length() const noexcept {
+        return prefix.size() + cycle.size();
+    }
+};
+
+
+/// Explicit-state CTL model checking over state sets. Backward operators walk
+/// the predecessor index; witnesses and counterexamples are shortest paths
+/// recovered from BFS parent arrays rather than stored predecessor lists.
+template<KripkeFrameLike Frame>
+class CtlChecker {
+
+private:
+    const Frame &m_frame;
+
+    static constexpr std::size_t no_parent = StateSet::npos;
+
+    /// BFS from `from` through states in `within` until a state in `target`
+    /// is reached; returns the shortest such path (from and target included).
+    [[nodiscard]] std::optional<std::vector<std::size_t>> shortest_path(std::size_t from, const StateSet &within, const StateSet &target) const {
+        if (target.test(from)) {
+            return std::vector<std::size_t>{from};
+        }
+        if (!within.test(from)) {
+            return std::nullopt;
+        }
+        std::vector<std::size_t> parent(m_frame.num_states(), no_parent);
+        std::vector<std::size_t> queue{from};
+        parent[from] = from;
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            const auto v = queue[head];
+            for (auto w: m_frame.successors(v)) {
+                if (parent[w] != no_parent) {
+                    continue;
+                }
+                parent[w] = v;
+                if (target.test(w)) {
+                    std::vector<std::size_t> path{w};
+                    while (path.back() != from) {
+                        path.push_back(parent[path.back()]);
+                    }
+                    std::reverse(path.begin(), path.end());
+                    return path;
+                }
+                if (within.test(w)) {
+                    queue.push_back(w);
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+public:
+    explicit CtlChecker(const Frame &frame) : m_frame(frame) {
+        frame.build_predecessor_index();
+    }
+
+    [[nodiscard]] auto frame() const -> const Frame & {
+        return m_frame;
+    }
+
+    [[nodiscard]] StateSet none() const {
+        return StateSet(m_frame.num_states());
+    }
+
+    [[nodiscard]] StateSet all() const {
+        return StateSet(m_frame.num_states(), true);
+    }
+
+    [[nodiscard]] StateSet atom(std::size_t prop) const requires Frame::has_proposition_labels {
+        return m_frame.states_with(prop);
+    }
+
+    /// EX phi: states with some successor in phi.
+    [[nodiscard]] StateSet ex(const StateSet &phi) const {
+        StateSet result = none();
+        phi.for_each([&](std::size_t t) {
+            for (auto s: m_frame.predecessors(t)) {
+                result.set(s);
+            }
+        });
+        return result;
+    }
+
+    [[nodiscard]] StateSet ax(const StateSet &phi) const {
+        return ~ex(~phi);
+    }
+
+    /// E[phi U psi]: backward BFS from psi through phi.
+    [[nodiscard]] StateSet eu(const StateSet &phi, const StateSet &psi) const {
+        StateSet result = psi;
+        std::vector<std::size_t> queue;
+        psi.for_each([&](std::size_t v) { queue.push_back(v); });
+        while (!queue.empty()) {
+            const auto t = queue.back();
+            queue.pop_back();
+            for (auto s: m_frame.predecessors(t)) {
+                if (phi.test(s) && result.insert(s)) {
+                    queue.push_back(s);
+                }
+            }
+        }
+        return result;
+    }
+
+    [[nodiscard]] StateSet ef(const StateSet &phi) const {
+        return eu(all(), phi);
+    }
+
+    /// EG phi: repeatedly drops phi-states without a successor left in the
+    /// set, tracking remaining successor counts so each edge is seen once.
+    [[nodiscard]] StateSet eg(const StateSet &phi) const {
+        StateSet result = phi;
+        std::vector<std::size_t> count(m_frame.num_states(), 0);
+        std::vector<std::size_t> queue;
+        phi.for_each([&](std::size_t v) {
+            for (auto w: m_frame.successors(v)) {
+                count[v] += phi.test(w);
+            }
+            if (count[v] == 0) {
+                queue.push_back(v);
+            }
+        });
+        while (!queue.empty()) {
+            const auto t = queue.back();
+            queue.pop_back();
+            result.reset(t);
+            for (auto s: m_frame.predecessors(t)) {
+                if (result.test(s) && --count[s] == 0) {
+                    queue.push_back(s);
+                }
+            }
+        }
+        return result;
+    }
+
+    [[nodiscard]] StateSet ag(const StateSet &phi) const {
+        return ~ef(~phi);
+    }
+
+    [[nodiscard]] StateSet af(const StateSet &phi) const {
+        return ~eg(~phi);
+    }
+
+    /// A[phi U psi] = !(E[!psi U (!phi & !psi)] | EG !psi).
+    [[nodiscard]] StateSet au(const StateSet &phi, const StateSet &psi) const {
+        const StateSet not_psi = ~psi;
+        return ~(eu(not_psi, ~phi & not_psi) | eg(not_psi));
+    }
+
+    /// Shortest finite witness of E[phi U psi] from a state.
+    [[nodiscard]] std::optional<Trace> witness_eu(std::size_t from, const StateSet &phi, const StateSet &psi) const {
+        auto path = shortest_path(from, phi, psi);
+        if (!path) {
+            return std::nullopt;
+        }
+        return Trace{std::move(*path), {}};
+    }
+
+    [[nodiscard]] std::optional<Trace> witness_ef(std::size_t from, const StateSet &phi) const {
+        return witness_eu(from, all(), phi);
+    }
+
+    /// A lasso from `from` that stays in `within` and whose cycle visits
+    /// `accepting`. The prefix to the cycle entry is a shortest one and the
+    /// cycle is a shortest one through that entry.
+    [[nodiscard]] std::optional<Trace> lasso(std::size_t from, const StateSet &within, const StateSet &accepting) const {
+        if (!within.test(from)) {
+            return std::nullopt;
+        }
+        const auto scc = strongly_connected_components(m_frame.num_states(), [&](std::size_t v, auto &&emit) {
+            if (within.test(v)) {
+                for (auto w: m_frame.successors(v)) {
+                    if (within.test(w)) {
+                        emit(w);
+                    }
+                }
+            }
+        });
+        // Cycle entries: accepting states of SCCs inside `within` that contain a cycle.
+        std::vector<char> cyclic(scc.count, 0);
+        within.for_each([&](std::size_t v) {
+            for (auto w: m_frame.successors(v)) {
+                if (within.test(w) && scc.component[w] == scc.component[v]) {
+                    cyclic[scc.component[v]] = 1;
+                }
+            }
+        });
+        StateSet entries = none();
+        (within & accepting).for_each([&](std::size_t v) {
+            if (cyclic[scc.component[v]]) {
+                entries.set(v);
+            }
+        });
+        auto stem = shortest_path(from, within, entries);
+        if (!stem) {
+            return std::nullopt;
+        }
+        const auto entry = stem->back();
+        stem->pop_back();
+
+        StateSet component = none();
+        within.for_each([&](std::size_t v) {
+            if (scc.component[v] == scc.component[entry]) {
+                component.set(v);
+            }
+        });
+        // Shortest cycle: BFS from the entry's successors back to the entry.
+        std::vector<std::size_t> parent(m_frame.num_states(), no_parent);
+        std::vector<std::size_t> queue{entry};
+        parent[entry] = entry;
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            const auto v = queue[head];
+            for (auto w: m_frame.successors(v)) {
+                if (w == entry) {
+                    std::vector<std::size_t> cycle{v};
+                    while (cycle.back() != entry) {
+                        cycle.push_back(parent[cycle.back()]);
+                    }
+                    std::reverse(cycle.begin(), cycle.end());
+                    return Trace{std::move(*stem), std::move(cycle)};
+                }
+                if (component.test(w) && parent[w] == no_parent) {
+                    parent[w] = v;
+                    queue.push_back(w);
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// Lasso witness of EG phi from a state.
+    [[nodiscard]] std::optional<Trace> witness_eg(std::size_t from, const StateSet &phi) const {
+        const StateSet z = eg(phi);
+        return lasso(from, z, z);
+    }
+
+    /// Counterexample to AG phi: shortest path to a state violating phi.
+    [[nodiscard]] std::optional<Trace> counterexample_ag(std::size_t from, const StateSet &phi) const {
+        return witness_ef(from, ~phi);
+    }
+
+    /// Counterexample to AF phi: a lasso on which phi never holds.
+    [[nodiscard]] std::optional<Trace> counterexample_af(std::size_t from, const StateSet &phi) const {
+        return witness_eg(from, ~phi);
+    }
+};
+
+/// CTL under fairness constraints: path quantifiers range only over fair
+/// paths. A Büchi constraint F asks for F infinitely often; a Streett pair
+/// (P, Q) asks that P infinitely often implies Q infinitely often.
+///
+/// Fair EG phi is E[phi U S] for S the union of fair SCCs of the phi
+/// subgraph (Emerson–Lei): an SCC missing some Büchi set is dropped, and one
+/// that visits P but not Q of a Streett pair is searched again with its P
+/// states removed. The other operators reduce to plain CTL restricted to the
+/// fair states, so everything stays on StateSet operations.
+template<KripkeFrameLike Frame>
+class FairCtlChecker {
+
+private:
+    CtlChecker<Frame> m_ctl;
+    std::vector<StateSet> m_buchi;
+    std::vector<std::pair<StateSet, StateSet>> m_streett;
+    mutable std::optional<StateSet> m_fair;
+
+    [[nodiscard]] std::size_t num_states() const {
+        return m_ctl.frame().num_states();
+    }
+
+    /// Union of the fair SCCs inside `within`. Components found in one round
+    /// are disjoint and not connected by cycles, so all the sets that need
+    /// another look are refined together in the next round; each round
+    /// retires at least one Streett pair per component, bounding the depth.
+    [[nodiscard]] StateSet fair_components(const StateSet &within) const {
+        const auto &frame = m_ctl.frame();
+        StateSet result = m_ctl.none();
+        StateSet current = within;
+        while (current.any()) {
+            const auto scc = strongly_connected_components(num_states(), [&](std::size_t v, auto &&emit) {
+                if (current.test(v)) {
+                    for (auto w: frame.successors(v)) {
+                        if (current.test(w)) {
+                            emit(w);
+                        }
+                    }
+                }
+            });
+            // Per component: a cycle, which Büchi sets it meets, and which
+            // Streett requests and responses it meets.
+            std::vector<char> cyclic(scc.count, 0);
+            std::vector<char> buchi(scc.count * m_buchi.size(), 0);
+            std::vector<char> request(scc.count * m_streett.size(), 0);
+            std::vector<char> response(scc.count * m_streett.size(), 0);
+            current.for_each([&](std::size_t v) {
+                const auto c = scc.component[v];
+                for (auto w: frame.successors(v)) {
+                    if (current.test(w) && scc.component[w] == c) {
+                        cyclic[c] = 1;
+                        break;
+                    }
+                }
+                for (std::size_t i = 0; i < m_buchi.size(); ++i) {
+                    buchi[c * m_buchi.size() + i] |= m_buchi[i].test(v);
+                }
+                for (std::size_t i = 0; i < m_streett.size(); ++i) {
+                    request[c * m_streett.size() + i] |= m_streett[i].first.test(v);
+                    response[c * m_streett.size() + i] |= m_streett[i].second.test(v);
+                }
+            });
+
+            // 0: drop, 1: fair, 2: refine without the offending requests.
+            std::vector<char> verdict(scc.count, 0);
+            for (std::size_t c = 0; c < scc.count; ++c) {
+                if (!cyclic[c]) {
+                    continue;
+                }
+                bool buchi_ok = true;
+                for (std::size_t i = 0; i < m_buchi.size(); ++i) {
+                    buchi_ok = buchi_ok && buchi[c * m_buchi.size() + i];
+                }
+                if (!buchi_ok) {
+                    continue;
+                }
+                verdict[c] = 1;
+                for (std::size_t i = 0; i < m_streett.size(); ++i) {
+                    if (request[c * m_streett.size() + i] && !response[c * m_streett.size() + i]) {
+                        verdict[c] = 2;
+                    }
+                }
+            }
+            StateSet next = m_ctl.none();
+            current.for_each([&](std::size_t v) {
+                const auto c = scc.component[v];
+                if (verdict[c] == 1) {
+                    result.set(v);
+                    return;
+                }
+                if (verdict[c] != 2) {
+                    return;
+                }
+                for (std::size_t i = 0; i < m_streett.size(); ++i) {
+                    if (m_streett[i].first.test(v) && !response[c * m_streett.size() + i]) {
+                        return;
+                    }
+                }
+                next.set(v);
+            });
+            current = std::move(next);
+        }
+        return result;
+    }
+
+    [[nodiscard]] StateSet singleton(std::size_t v) const {
+        StateSet set = m_ctl.none();
+        set.set(v);
+        return set;
+    }
+
+    /// Appends the shortest path within `within` from path.back() to `to`.
+    bool extend(std::vector<std::size_t> &path, const StateSet &within, std::size_t to) const {
+        auto segment = m_ctl.witness_eu(path.back(), within, singleton(to));
+        if (!segment) {
+            return false;
+        }
+        path.insert(path.end(), segment->prefix.begin() + 1, segment->prefix.end());
+        return true;
+    }
+
+public:
+    explicit FairCtlChecker(const Frame &frame) : m_ctl(frame) {}
+
+    [[nodiscard]] auto checker() const -> const CtlChecker<Frame> & {
+        return m_ctl;
+    }
+
+    /// Requires `states` to be visited infinitely often.
+    void add_buchi(StateSet states) {
+        m_buchi.push_back(std::move(states));
+        m_fair.reset();
+    }
+
+    void add_buchi(std::size_t prop) requires Frame::has_proposition_labels {
+        add_buchi(m_ctl.atom(prop));
+    }
+
+    /// Requires `response` infinitely often on paths with `request` infinitely often.
+    void add_streett(StateSet request, StateSet response) {
+        m_streett.emplace_back(std::move(request), std::move(response));
+        m_fair.reset();
+    }
+
+    void add_streett(std::size_t request, std::size_t response) requires Frame::has_proposition_labels {
+        add_streett(m_ctl.atom(request), m_ctl.atom(response));
+    }
+
+    /// States with at least one fair path.
+    [[nodiscard]] auto fair() const -> const StateSet & {
+        if (!m_fair) {
+            m_fair = eg(m_ctl.all());
+        }
+        return *m_fair;
+    }
+
+    [[nodiscard]] StateSet eg(const StateSet &phi) const {
+        return m_ctl.eu(phi, fair_components(phi));
+    }
+
+    [[nodiscard]] StateSet ex(const StateSet &phi) const {
+        return m_ctl.ex(phi & fair());
+    }
+
+    [[nodiscard]] StateSet eu(const StateSet &phi, const StateSet &psi) const {
+        return m_ctl.eu(phi, psi & fair());
+    }
+
+    [[nodiscard]] StateSet ef(const StateSet &phi) const {
+        return eu(m_ctl.all(), phi);
+    }
+
+    [[nodiscard]] StateSet ax(const StateSet &phi) const {
+        return ~ex(~phi);
+    }
+
+    [[nodiscard]] StateSet ag(const StateSet &phi) const {
+        return ~ef(~phi);
+    }
+
+    [[nodiscard]] StateSet af(const StateSet &phi) const {
+        return ~eg(~phi);
+    }
+
+    [[nodiscard]] StateSet au(const StateSet &phi, const StateSet &psi) const {
+        const StateSet not_psi = ~psi;
+        return ~(eu(not_psi, ~phi & not_psi) | eg(not_psi));
+    }
+
+    /// A fair lasso from `from` on which phi always holds: a shortest stem
+    /// into a fair SCC, then a cycle through one state of every Büchi set and
+    /// every Streett response that the SCC contains.
+    [[nodiscard]] std::optional<Trace> witness_eg(std::size_t from, const StateSet &phi) const {
+        const StateSet fair_sccs = fair_components(phi);
+        auto stem = m_ctl.witness_eu(from, phi, fair_sccs);
+        if (!stem) {
+            return std::nullopt;
+        }
+        const auto entry = stem->prefix.back();
+        stem->prefix.pop_back();
+
+        const auto &frame = m_ctl.frame();
+        const auto scc = strongly_connected_components(num_states(), [&](std::size_t v, auto &&emit) {
+            if (fair_sccs.test(v)) {
+                for (auto w: frame.successors(v)) {
+                    if (fair_sccs.test(w)) {
+                        emit(w);
+                    }
+                }
+            }
+        });
+        StateSet component = m_ctl.none();
+        fair_sccs.for_each([&](std::size_t v) {
+            if (scc.component[v] == scc.component[entry]) {
+                component.set(v);
+            }
+        });
+
+        std::vector<std::size_t> path{entry};
+        auto visit = [&](const StateSet &states) {
+            const auto v = (states & component).find_first();
+            return v == StateSet::npos || extend(path, component, v);
+        };
+        for (const auto &f: m_buchi) {
+            visit(f);
+        }
+        for (const auto &[request, response]: m_streett) {
+            visit(response);
+        }
+        if (path.size() == 1) {
+            // Nothing to visit: take any step inside the component first.
+            const auto succ = frame.successors(entry);
+            const auto next = std::find_if(succ.begin(), succ.end(), [&](auto w) { return component.test(w); });
+            if (*next == entry) {
+                return Trace{std::move(stem->prefix), {entry}};
+            }
+            path.push_back(*next);
+        }
+        if (path.back() != entry) {
+            extend(path, component, entry);
+        }
+        path.pop_back();
+        return Trace{std::move(stem->prefix), std::move(path)};
+    }
+};
+
+struct RecheckStats {
+    std::size_t edited_states = 0;
+    std::size_t affected_states = 0;
+    std::size_t formulas = 0;
+};
+
+
+/// CTL checking that survives frame edits. The checker owns the frame, so
+/// every add_state/add_transition/set_label goes through it and marks the
+/// edited source state. A state's satisfaction of any CTL formula depends
+/// only on the states it can reach, so on the next query only the states
+/// that can reach an edit (the affected region) are recomputed; every
+/// fixpoint treats values outside the region as fixed.
+template<typename State, typename Label>
+class IncrementalCtlChecker {
+
+public:
+    using FrameType = KripkeFrame<State, Label>;
+    using FormulaId = std::size_t;
+
+private:
+    enum class Kind {
+        constant, atom, negation, conjunction, disjunction, ex, eu, eg
+    };
+
+    struct Formula {
+        Kind kind;
+        std::size_t lhs = 0;
+        std::size_t rhs = 0;
+    };
+
+    FrameType m_frame;
+    std::vector<Formula> m_formulas;
+    std::vector<StateSet> m_sat;
+
+    std::vector<std::size_t> m_edited;
+    StateSet m_in_region;
+    std::vector<std::size_t> m_region;
+    std::vector<std::size_t> m_count;
+    RecheckStats m_last;
+
+    void mark_edited(std::size_t idx) {
+        m_edited.push_back(idx);
+    }
+
+    [[nodiscard]] bool in_region(std::size_t idx) const {
+        return m_in_region.test(idx);
+    }
+
+    /// Recomputes m_sat[f] on the states of m_region.
+    void evaluate(std::size_t f) {
+        const auto &formula = m_formulas[f];
+        auto &sat = m_sat[f];
+        switch (formula.kind) {
+            case Kind::constant:
+                for (auto s: m_region) {
+                    sat.set(s, formula.lhs != 0);
+                }
+                break;
+            case Kind::atom:
+                if constexpr (FrameType::has_proposition_labels) {
+                    for (auto s: m_region) {
+                        sat.set(s, m_frame.holds(s, formula.lhs));
+                    }
+                }
+                break;
+            case Kind::negation:
+                for (auto s: m_region) {
+                    sat.set(s, !m_sat[formula.lhs].test(s));
+                }
+                break;
+            case Kind::conjunction:
+                for (auto s: m_region) {
+                    sat.set(s, m_sat[formula.lhs].test(s) && m_sat[formula.rhs].test(s));
+                }
+                break;
+            case Kind::disjunction:
+                for (auto s: m_region) {
+                    sat.set(s, m_sat[formula.lhs].test(s) || m_sat[formula.rhs].test(s));
+                }
+                break;
+            case Kind::ex:
+                for (auto s: m_region) {
+                    const auto succ = m_frame.successors(s);
+                    sat.set(s, std::any_of(succ.begin(), succ.end(), [&](auto t) { return m_sat[formula.lhs].test(t); }));
+                }
+                break;
+            case Kind::eu: {
+                const auto &phi = m_sat[formula.lhs];
+                const auto &psi = m_sat[formula.rhs];
+                std::vector<std::size_t> queue;
+                for (auto s: m_region) {
+                    sat.reset(s);
+                }
+                for (auto s: m_region) {
+                    const auto succ = m_frame.successors(s);
+                    if (psi.test(s) || (phi.test(s) && std::any_of(succ.begin(), succ.end(), [&](auto t) {
+                        return !in_region(t) && sat.test(t);
+                    }))) {
+                        sat.set(s);
+                        queue.push_back(s);
+                    }
+                }
+                while (!queue.empty()) {
+                    const auto t = queue.back();
+                    queue.pop_back();
+                    for (auto s: m_frame.predecessors(t)) {
+                        if (in_region(s) && phi.test(s) && sat.insert(s)) {
+                            queue.push_back(s);
+                        }
+                    }
+                }
+                break;
+            }
+            case Kind::eg: {
+                const auto &phi = m_sat[formula.lhs];
+                std::vector<std::size_t> queue;
+                for (auto s: m_region) {
+                    sat.set(s, phi.test(s));
+                }
+                for (auto s: m_region) {
+                    if (!sat.test(s)) {
+                        continue;
+                    }
+                    m_count[s] = 0;
+                    for (auto t: m_frame.successors(s)) {
+                        m_count[s] += sat.test(t);
+                    }
+                    if (m_count[s] == 0) {
+                        queue.push_back(s);
+                    }
+                }
+                while (!queue.empty()) {
+                    const auto t = queue.back();
+                    queue.pop_back();
+                    sat.reset(t);
+                    for (auto s: m_frame.predecessors(t)) {
+                        if (in_region(s) && sat.test(s) && --m_count[s] == 0) {
+                            queue.push_back(s);
+                        }
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    /// Makes m_region hold every state.
+    void select_all() {
+        m_region.resize(m_frame.num_states());
+        std::iota(m_region.begin(), m_region.end(), 0);
+        m_in_region.fill(true);
+    }
+
+    void clear_region() {
+        for (auto s: m_region) {
+            m_in_region.reset(s);
+        }
+        m_region.clear();
+    }
+
+    FormulaId add(Formula formula) {
+        recheck();
+        m_formulas.push_back(formula);
+        m_sat.emplace_back(m_frame.num_states());
+        select_all();
+        evaluate(m_formulas.size() - 1);
+        clear_region();
+        return m_formulas.size() - 1;
+    }
+
+public:
+    /// Builds the frame's reverse index, which edits then keep current.
+    explicit IncrementalCtlChecker(FrameType frame) : m_frame(std::move(frame)) {
+        m_frame.build_predecessor_index();
+        m_in_region = StateSet(m_frame.num_states());
+        m_count.assign(m_frame.num_states(), 0);
+    }
+
+    [[nodiscard]] auto frame() const -> const FrameType & {
+        return m_frame;
+    }
+
+    /// Returns the state's index. If the frame interns states and already
+    /// holds state, nothing changes and its existing index is returned.
+    std::size_t add_state(const State &state, const Label &label) {
+        const auto before = m_frame.num_states();
+        const auto idx = m_frame.add_state(state, label);
+        if (m_frame.num_states() == before) {
+            return idx;
+        }
+        for (auto &sat: m_sat) {
+            sat.push_back(false);
+        }
+        m_in_region.push_back(false);
+        m_count.push_back(0);
+        mark_edited(idx);
+        return idx;
+    }
+
+    void add_transition(std::size_t from, std::size_t to) {
+        m_frame.add_transition(from, to);
+        mark_edited(from);
+    }
+
+    void set_label(std::size_t idx, const Label &label) {
+        m_frame.set_label(idx, label);
+        mark_edited(idx);
+    }
+
+    FormulaId constant(bool value) {
+        return add({Kind::constant, value ? 1u : 0u});
+    }
+
+    FormulaId atom(std::size_t prop) requires FrameType::has_proposition_labels {
+        return add({Kind::atom, prop});
+    }
+
+    FormulaId negation(FormulaId f) {
+        return add({Kind::negation, f});
+    }
+
+    FormulaId conjunction(FormulaId f, FormulaId g) {
+        return add({Kind::conjunction, f, g});
+    }
+
+    FormulaId disjunction(FormulaId f, FormulaId g) {
+        return add({Kind::disjunction, f, g});
+    }
+
+    FormulaId ex(FormulaId f) {
+        return add({Kind::ex, f});
+    }
+
+    FormulaId eu(FormulaId f, FormulaId g) {
+        return add({Kind::eu, f, g});
+    }
+
+    FormulaId eg(FormulaId f) {
+        return add({Kind::eg, f});
+    }
+
+    /// States satisfying f, after bringing all formulas up to date.
+    [[nodiscard]] auto satisfying(FormulaId f) -> const StateSet & {
+        recheck();
+        return m_sat[f];
+    }
+
+    /// Recomputes all formulas on the states that can reach an edit.
+    /// Does nothing if the frame has not changed since the last check.
+    void recheck() {
+        if (m_edited.empty()) {
+            return;
+        }
+        m_last = {};
+        m_last.edited_states = m_edited.size();
+        for (auto s: m_edited) {
+            if (!in_region(s)) {
+                m_in_region.set(s);
+                m_region.push_back(s);
+            }
+        }
+        m_edited.clear();
+        for (std::size_t head = 0; head < m_region.size(); ++head) {
+            for (auto s: m_frame.predecessors(m_region[head])) {
+                if (!in_region(s)) {
+                    m_in_region.set(s);
+                    m_region.push_back(s);
+                }
+            }
+        }
+        m_last.affected_states = m_region.size();
+        m_last.formulas = m_formulas.size();
+        for (std::size_t f = 0; f < m_formulas.size(); ++f) {
+            evaluate(f);
+        }
+        clear_region();
+    }
+
+    [[nodiscard]] auto last_recheck() const noexcept -> const RecheckStats & {
+        return m_last;
+    }
+};
+
+/// Canonicalizer for fully symmetric components: each projection selects one
+/// group of interchangeable components of a state (e.g. the local states of
+/// identical processes) and the group is sorted in place. Sorting is only a
+/// valid canonical form if no other part of the state refers to components
+/// by position; otherwise supply a custom canonicalizer.
+template<typename... Projections>
+struct SortComponents {
+    std::tuple<Projections...> projections;
+
+    explicit SortComponents(Projections... projs) : projections(std::move(projs)...) {}
+
+    template<typename State>
+    void operator()(State &state) const {
+        std::apply([&](const auto &...proj) { (std::ranges::sort(proj(state)), ...); }, projections);
+    }
+};
+
+
+/// Exposes G::LabelType, if any, to generator adapters deriving from it.
+template<typename G>
+struct GeneratorLabelBase {};
+
+template<LabelledStateGenerator G>
+struct GeneratorLabelBase<G> {
+    using LabelType = typename G::LabelType;
+};
+
+
+/// Generator adapter for symmetry reduction: every state it hands out is
+/// replaced by its canonical representative, so explorers store one state
+/// per orbit and build_frame() yields the quotient frame. Labels must be
+/// invariant under the declared symmetry for verification results to carry over.
+template<StateGenerator Generator, typename Canonicalize>
+class SymmetryReducedGenerator : public GeneratorLabelBase<Generator> {
+
+public:
+    using StateType = typename Generator::StateType;
+
+private:
+    const Generator &m_gen;
+    Canonicalize m_canonicalize;
+
+public:
+    SymmetryReducedGenerator(const Generator &gen, Canonicalize canonicalize)
+            : m_gen(gen), m_canonicalize(std::move(canonicalize)) {}
+
+    [[nodiscard]] StateType canonical(StateType state) const {
+        m_canonicalize(state);
+        return state;
+    }
+
+    [[nodiscard]] std::vector<StateType> initial_states() const {
+        std::vector<StateType> states;
+        for (auto state: m_gen.initial_states()) {
+            states.push_back(canonical(std::move(state)));
+        }
+        return states;
+    }
+
+    template<typename Emit>
+    void successors(const StateType &state, Emit &&emit) const {
+        m_gen.successors(state, [&](const StateType &succ) {
+            emit(canonical(succ));
+        });
+    }
+
+    [[nodiscard]] auto label(const StateType &state) const requires LabelledStateGenerator<Generator> {
+        return m_gen.label(state);
+    }
+};
+
+/// CDCL SAT solver: two watched literals with blocking literals, VSIDS
+/// branching with phase saving, first-UIP clause learning with local
+/// minimization, Luby restarts and activity-based learnt clause deletion.
+///
+/// The solver is incremental: clauses may be added between solve() calls,
+/// learnt clauses are kept, and solve() takes assumption literals that only
+/// hold for that call. Literals use the DIMACS convention: variable v
+/// (numbered from 1) is v, its negation -v.
+class SatSolver {
+
+public:
+    enum class Result {
+        satisfiable, unsatisfiable, unknown
+    };
+
+private:
+    /// Internal literal: 2 * var + (negated ? 1 : 0), var numbered from 0.
+    using Lit = std::uint32_t;
+    using ClauseRef = std::uint32_t;
+
+    static constexpr ClauseRef no_reason = static_cast<ClauseRef>(-1);
+    static constexpr std::int8_t l_true = 1;
+    static constexpr std::int8_t l_false = 0;
+    static constexpr std::int8_t l_undef = 2;
+
+    struct Clause {
+        std::vector<Lit> lits;
+        double activity = 0;
+        bool learnt = false;
+        bool deleted = false;
+    };
+
+    struct Watcher {
+        ClauseRef clause;
+        Lit blocker;
+    };
+
+    std::vector<Clause> m_clauses;
+    std::vector<ClauseRef> m_learnts;
+    std::vector<std::vector<Watcher>> m_watches;
+
+    std::vector<std::int8_t> m_assigns;
+    std::vector<std::int8_t> m_phase;
+    std::vector<std::uint32_t> m_level;
+    std::vector<ClauseRef> m_reason;
+    std::vector<Lit> m_trail;
+    std::vector<std::size_t> m_trail_lim;
+    std::size_t m_qhead = 0;
+
+    std::vector<double> m_activity;
+    std::vector<std::uint32_t> m_heap;
+    std::vector<std::int64_t> m_heap_index;
+    double m_var_inc = 1;
+    double m_clause_inc = 1;
+
+    std::vector<char> m_seen;
+    std::vector<std::int8_t> m_model;
+    bool m_ok = true;
+    double m_max_learnts = 0;
+    std::uint64_t m_conflicts = 0;
+    std::uint64_t m_decisions = 0;
+    std::uint64_t m_propagations = 0;
+
+    static Lit negate(Lit l) noexcept {
+        return l ^ 1u;
+    }
+
+    static std::uint32_t var_of(Lit l) noexcept {
+        return l >> 1;
+    }
+
+    static Lit from_dimacs(int lit) noexcept {
+        return lit > 0 ? 2u * static_cast<Lit>(lit - 1) : 2u * static_cast<Lit>(-lit - 1) + 1u;
+    }
+
+    [[nodiscard]] std::int8_t value(Lit l) const noexcept {
+        const auto v = m_assigns[var_of(l)];
+        return v == l_undef ? l_undef : static_cast<std::int8_t>(v ^ static_cast<std::int8_t>(l & 1u));
+    }
+
+    [[nodiscard]] std::uint32_t decision_level() const noexcept {
+        return static_cast<std::uint32_t>(m_trail_lim.size());
+    }
+
+    // --- VSIDS order heap (max-heap on activity) ---
+
+    [[nodiscard]] bool heap_less(std::uint32_t a, std::uint32_t b) const {
+        return m_activity[a] > m_activity[b];
+    }
+
+    void heap_up(std::size_t i) {
+        const auto v = m_heap[i];
+        while (i > 0 && heap_less(v, m_heap[(i - 1) / 2])) {
+            m_heap[i] = m_heap[(i - 1) / 2];
+            m_heap_index[m_heap[i]] = static_cast<std::int64_t>(i);
+            i = (i - 1) / 2;
+        }
+        m_heap[i] = v;
+        m_heap_index[v] = static_cast<std::int64_t>(i);
+    }
+
+    void heap_down(std::size_t i) {
+        const auto v = m_heap[i];
+        for (;;) {
+            std::size_t child = 2 * i + 1;
+            if (child >= m_heap.size()) {
+                break;
+            }
+            if (child + 1 < m_heap.size() && heap_less(m_heap[child + 1], m_heap[child])) {
+                ++child;
+            }
+            if (!heap_less(m_heap[child], v)) {
+                break;
+            }
+            m_heap[i] = m_heap[child];
+            m_heap_index[m_heap[i]] = static_cast<std::int64_t>(i);
+            i = child;
+        }
+        m_heap[i] = v;
+        m_heap_index[v] = static_cast<std::int64_t>(i);
+    }
+
+    void heap_insert(std::uint32_t v) {
+        if (m_heap_index[v] >= 0) {
+            return;
+        }
+        m_heap.push_back(v);
+        heap_up(m_heap.size() - 1);
+    }
+
+    std::uint32_t heap_pop() {
+        const auto top = m_heap.front();
+        m_heap_index[top] = -1;
+        m_heap.front() = m_heap.back();
+        m_heap.pop_back();
+        if (!m_heap.empty()) {
+            heap_down(0);
+        }
+        return top;
+    }
+
+    void bump_var(std::uint32_t v) {
+        if ((m_activity[v] += m_var_inc) > 1e100) {
+            for (auto &a: m_activity) {
+                a *= 1e-100;
+            }
+            m_var_inc *= 1e-100;
+        }
+        if (m_heap_index[v] >= 0) {
+            heap_up(static_cast<std::size_t>(m_heap_index[v]));
+        }
+    }
+
+    void bump_clause(Clause &c) {
+        if ((c.activity += m_clause_inc) > 1e20) {
+            for (auto ref: m_learnts) {
+                m_clauses[ref].activity *= 1e-20;
+            }
+            m_clause_inc *= 1e-20;
+        }
+    }
+
+    // --- assignment and propagation ---
+
+    void enqueue(Lit l, ClauseRef reason) {
+        const auto v = var_of(l);
+        m_assigns[v] = static_cast<std::int8_t>((l & 1u) ? l_false : l_true);
+        m_level[v] = decision_level();
+        m_reason[v] = reason;
+        m_trail.push_back(l);
+    }
+
+    void attach(ClauseRef ref) {
+        const auto &lits = m_clauses[ref].lits;
+        m_watches[negate(lits[0])].push_back({ref, lits[1]});
+        m_watches[negate(lits[1])].push_back({ref, lits[0]});
+    }
+
+    /// Unit propagation; returns the conflicting clause or no_reason.
+    ClauseRef propagate() {
+        while (m_qhead < m_trail.size()) {
+            const Lit p = m_trail[m_qhead++];
+            ++m_propagations;
+            auto &watchers = m_watches[p];
+            std::size_t keep = 0;
+            for (std::size_t i = 0; i < watchers.size(); ++i) {
+                const auto w = watchers[i];
+                auto &clause = m_clauses[w.clause];
+                if (clause.deleted) {
+                    continue;
+                }
+                if (value(w.blocker) == l_true) {
+                    watchers[keep++] = w;
+                    continue;
+                }
+                auto &lits = clause.lits;
+                const Lit false_lit = negate(p);
+                if (lits[0] == false_lit) {
+                    std::swap(lits[0], lits[1]);
+                }
+                if (value(lits[0]) == l_true) {
+                    watchers[keep++] = {w.clause, lits[0]};
+                    continue;
+                }
+                bool moved = false;
+                for (std::size_t k = 2; k < lits.size(); ++k) {
+                    if (value(lits[k]) != l_false) {
+                        std::swap(lits[1], lits[k]);
+                        m_watches[negate(lits[1])].push_back({w.clause, lits[0]});
+                        moved = true;
+                        break;
+                    }
+                }
+                if (moved) {
+                    continue;
+                }
+                watchers[keep++] = {w.clause, lits[0]};
+                if (value(lits[0]) == l_false) {
+                    for (++i; i < watchers.size(); ++i) {
+                        watchers[keep++] = watchers[i];
+                    }
+                    watchers.resize(keep);
+                    m_qhead = m_trail.size();
+                    return w.clause;
+                }
+                enqueue(lits[0], w.clause);
+            }
+            watchers.resize(keep);
+        }
+        return no_reason;
+    }
+
+    void cancel_until(std::uint32_t level) {
+        if (decision_level() <= level) {
+            return;
+        }
+        for (auto i = m_trail.size(); i-- > m_trail_lim[level];) {
+            const auto v = var_of(m_trail[i]);
+            m_phase[v] = m_assigns[v];
+            m_assigns[v] = l_undef;
+            m_reason[v] = no_reason;
+            heap_insert(v);
+        }
+        m_trail.resize(m_trail_lim[level]);
+        m_trail_lim.resize(level);
+        m_qhead = m_trail.size();
+    }
+
+    /// A literal is redundant in a learnt clause if its reason clause only
+    /// contains literals already in the clause (one level of minimization).
+    [[nodiscard]] bool redundant(Lit l) const {
+        const auto reason = m_reason[var_of(l)];
+        if (reason == no_reason) {
+            return false;
+        }
+        for (auto q: m_clauses[reason].lits) {
+            const auto v = var_of(q);
+            if (v != var_of(l) && !m_seen[v] && m_level[v] > 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// First-UIP conflict analysis; returns the learnt clause (asserting
+    /// literal first) and the backjump level.
+    std::pair<std::vector<Lit>, std::uint32_t> analyze(ClauseRef conflict) {
+        std::vector<Lit> learnt{0};
+        std::size_t pending = 0;
+        Lit p = 0;
+        bool have_p = false;
+        auto index = m_trail.size();
+        do {
+            auto &clause = m_clauses[conflict];
+            if (clause.learnt) {
+                bump_clause(clause);
+            }
+            for (auto q: clause.lits) {
+                if (have_p && q == p) {
+                    continue;
+                }
+                const auto v = var_of(q);
+                if (!m_seen[v] && m_level[v] > 0) {
+                    m_seen[v] = 1;
+                    bump_var(v);
+                    if (m_level[v] >= decision_level()) {
+                        ++pending;
+                    } else {
+                        learnt.push_back(q);
+                    }
+                }
+            }
+            while (!m_seen[var_of(m_trail[--index])]) {}
+            p = m_trail[index];
+            have_p = true;
+            conflict = m_reason[var_of(p)];
+            m_seen[var_of(p)] = 0;
+            --pending;
+        } while (pending > 0);
+        learnt[0] = negate(p);
+
+        std::vector<Lit> minimized{learnt[0]};
+        for (std::size_t i = 1; i < learnt.size(); ++i) {
+            if (!redundant(learnt[i])) {
+                minimized.push_back(learnt[i]);
+            }
+        }
+        for (auto l: learnt) {
+            m_seen[var_of(l)] = 0;
+        }
+
+        std::uint32_t backjump = 0;
+        if (minimized.size() > 1) {
+            std::size_t max_i = 1;
+            for (std::size_t i = 2; i < minimized.size(); ++i) {
+                if (m_level[var_of(minimized[i])] > m_level[var_of(minimized[max_i])]) {
+                    max_i = i;
+                }
+            }
+            std::swap(minimized[1], minimized[max_i]);
+            backjump = m_level[var_of(minimized[1])];
+        }
+        return {std::move(minimized), backjump};
+    }
+
+    void reduce_learnts() {
+        std::sort(m_learnts.begin(), m_learnts.end(), [&](auto a, auto b) {
+            return m_clauses[a].activity < m_clauses[b].activity;
+        });
+        std::vector<ClauseRef> kept;
+        for (std::size_t i = 0; i < m_learnts.size(); ++i) {
+            auto &clause = m_clauses[m_learnts[i]];
+            const auto first = var_of(clause.lits[0]);
+            const bool locked = m_reason[first] == m_learnts[i] && value(clause.lits[0]) == l_true;
+            if (i < m_learnts.size() / 2 && clause.lits.size() > 2 && !locked) {
+                clause.deleted = true;
+                clause.lits.clear();
+                clause.lits.shrink_to_fit();
+            } else {
+                kept.push_back(m_learnts[i]);
+            }
+        }
+        m_learnts = std::move(kept);
+        for (auto &watchers: m_watches) {
+            std::erase_if(watchers, [&](const Watcher &w) { return m_clauses[w.clause].deleted; });
+        }
+    }
+
+    static double luby(double y, std::uint64_t x) {
+        std::uint64_t size = 1;
+        std::uint64_t seq = 0;
+        while (size < x + 1) {
+            ++seq;
+            size = 2 * size + 1;
+        }
+        while (size - 1 != x) {
+            size = (size - 1) >> 1;
+            --seq;
+            x = x % size;
+        }
+        return std::pow(y, static_cast<double>(seq));
+    }
+
+    /// CDCL search until a result or conflict budget is reached.
+    Result search(std::uint64_t budget, const std::vector<Lit> &assumptions) {
+        for (std::uint64_t conflicts = 0;;) {
+            const auto conflict = propagate();
+            if (conflict != no_reason) {
+                ++m_conflicts;
+                ++conflicts;
+                if (decision_level() == 0) {
+                    m_ok = false;
+                    return Result::unsatisfiable;
+                }
+                auto [learnt, backjump] = analyze(conflict);
+                cancel_until(backjump);
+                if (learnt.size() == 1) {
+                    enqueue(learnt[0], no_reason);
+                } else {
+                    const auto ref = static_cast<ClauseRef>(m_clauses.size());
+                    m_clauses.push_back({std::move(learnt), 0, true, false});
+                    m_learnts.push_back(ref);
+                    attach(ref);
+                    bump_clause(m_clauses[ref]);
+                    enqueue(m_clauses[ref].lits[0], ref);
+                }
+                m_var_inc /= 0.95;
+                m_clause_inc /= 0.999;
+                continue;
+            }
+            if (conflicts >= budget) {
+                cancel_until(0);
+                return Result::unknown;
+            }
+            if (static_cast<double>(m_learnts.size()) >= m_max_learnts + static_cast<double>(m_trail.size())) {
+                reduce_learnts();
+            }
+            Lit next = 0;
+            bool have_next = false;
+            while (decision_level() < assumptions.size()) {
+                const auto a = assumptions[decision_level()];
+                if (value(a) == l_true) {
+                    m_trail_lim.push_back(m_trail.size());
+                } else if (value(a) == l_false) {
+                    return Result::unsatisfiable;
+                } else {
+                    next = a;
+                    have_next = true;
+                    break;
+                }
+            }
+            if (!have_next) {
+                while (!m_heap.empty() && m_assigns[m_heap.front()] != l_undef) {
+                    heap_pop();
+                }
+                if (m_heap.empty()) {
+                    return Result::satisfiable;
+                }
+                const auto v = heap_pop();
+                next = 2 * v + (m_phase[v] == l_true ? 0u : 1u);
+                ++m_decisions;
+            }
+            m_trail_lim.push_back(m_trail.size());
+            enqueue(next, no_reason);
+        }
+    }
+
+public:
+    SatSolver() = default;
+
+    /// Creates a fresh variable and returns its (positive, 1-based) number.
+    int new_var() {
+        const auto v = static_cast<std::uint32_t>(m_assigns.size());
+        m_assigns.push_back(l_undef);
+        m_phase.push_back(l_false);
+        m_level.push_back(0);
+        m_reason.push_back(no_reason);
+        m_activity.push_back(0);
+        m_heap_index.push_back(-1);
+        m_seen.push_back(0);
+        m_watches.emplace_back();
+        m_watches.emplace_back();
+        heap_insert(v);
+        return static_cast<int>(v + 1);
+    }
+
+    [[nodiscard]] std::size_t num_vars() const noexcept {
+        return m_assigns.size();
+    }
+
+    [[nodiscard]] std::size_t num_clauses() const noexcept {
+        return m_clauses.size() - m_learnts.size();
+    }
+
+    [[nodiscard]] std::size_t num_learnts() const noexcept {
+        return m_learnts.size();
+    }
+
+    [[nodiscard]] std::uint64_t conflicts() const noexcept {
+        return m_conflicts;
+    }
+
+    [[nodiscard]] std::uint64_t decisions() const noexcept {
+        return m_decisions;
+    }
+
+    [[nodiscard]] std::uint64_t propagations() const noexcept {
+        return m_propagations;
+    }
+
+    /// Adds a clause of DIMACS literals, creating variables as needed.
+    /// Returns false once the clause set is unsatisfiable at level 0.
+    bool add_clause(std::span<const int> dimacs) {
+        if (!m_ok) {
+            return false;
+        }
+        cancel_until(0);
+        std::vector<Lit> lits;
+        for (auto d: dimacs) {
+            while (static_cast<std::size_t>(std::abs(d)) > num_vars()) {
+                new_var();
+            }
+            lits.push_back(from_dimacs(d));
+        }
+        std::sort(lits.begin(), lits.end());
+        lits.erase(std::unique(lits.begin(), lits.end()), lits.end());
+        std::vector<Lit> kept;
+        for (std::size_t i = 0; i < lits.size(); ++i) {
+            if (value(lits[i]) == l_true || (i + 1 < lits.size() && lits[i + 1] == negate(lits[i]))) {
+                return true;
+            }
+            if (value(lits[i]) != l_false) {
+                kept.push_back(lits[i]);
+            }
+        }
+        if (kept.empty()) {
+            return m_ok = false;
+        }
+        if (kept.size() == 1) {
+            enqueue(kept[0], no_reason);
+            return m_ok = propagate() == no_reason;
+        }
+        const auto ref = static_cast<ClauseRef>(m_clauses.size());
+        m_clauses.push_back({std::move(kept), 0, false, false});
+        attach(ref);
+        return true;
+    }
+
+    bool add_clause(std::initializer_list<int> dimacs) {
+        return add_clause(std::span<const int>(dimacs.begin(), dimacs.size()));
+    }
+
+    /// Solves under the given assumption literals. conflict_budget bounds the
+    /// work; Result::unknown is returned when it runs out.
+    Result solve(std::span<const int> assumptions = {},
+                 std::uint64_t conflict_budget = static_cast<std::uint64_t>(-1)) {
+        m_model.clear();
+        if (!m_ok) {
+            return Result::unsatisfiable;
+        }
+        std::vector<Lit> assumed;
+        for (auto a: assumptions) {
+            while (static_cast<std::size_t>(std::abs(a)) > num_vars()) {
+                new_var();
+            }
+            assumed.push_back(from_dimacs(a));
+        }
+        Result result = Result::unknown;
+        m_max_learnts = std::max(static_cast<double>(num_clauses()) / 3, 5000.0);
+        for (std::uint64_t restart = 0; result == Result::unknown && conflict_budget > 0; ++restart) {
+            const auto limit = std::min(conflict_budget, static_cast<std::uint64_t>(luby(2, restart) * 100));
+            const auto before = m_conflicts;
+            result = search(limit, assumed);
+            conflict_budget -= std::min(conflict_budget, m_conflicts - before);
+            m_max_learnts *= 1.1;
+        }
+        if (result == Result::satisfiable) {
+            m_model = m_assigns;
+        }
+        cancel_until(0);
+        return result;
+    }
+
+    /// Value of a variable in the model found by the last satisfiable solve().
+    [[nodiscard]] bool model_value(int var) const {
+        return m_model[static_cast<std::size_t>(var - 1)] == l_true;
+    }
+
+    /// Reads a DIMACS CNF file into the solver; returns false on malformed
+    /// input. Lines starting with 'c' are comments, and a '%' line (as in the
+    /// SATLIB benchmarks) ends the input. Once a clause makes the set
+    /// unsatisfiable at level 0, later clauses are only parsed, and solve()
+    /// returns unsatisfiable.
+    bool read_dimacs(std::istream &in) {
+        std::string token;
+        std::vector<int> clause;
+        bool consistent = true;
+        while (in >> token) {
+            if (token.front() == 'c') {
+                std::getline(in, token);
+            } else if (token == "%") {
+                break;
+            } else if (token == "p") {
+                std::string format;
+                std::size_t vars = 0, clauses = 0;
+                if (!(in >> format >> vars >> clauses) || format != "cnf") {
+                    return false;
+                }
+                while (num_vars() < vars) {
+                    new_var();
+                }
+            } else {
+                int lit = 0;
+                const auto *last = token.data() + token.size();
+                const auto [end, error] = std::from_chars(token.data(), last, lit);
+                if (error != std::errc() || end != last || lit == std::numeric_limits<int>::min()) {
+                    return false;
+                }
+                if (lit == 0) {
+                    consistent = consistent && add_clause(clause);
+                    clause.clear();
+                } else {
+                    clause.push_back(lit);
+                }
+            }
+        }
+        return clause.empty();
+    }
+};
+
+
+struct BmcCounterexample {
+    /// Number of transitions from the initial state to the bad state.
+    std::size_t depth = 0;
+    /// State indices (in SymbolicKripkeFrame encoding) along the path.
+    std::vector<std::size_t> states;
+};
+
+
+/// SAT-based bounded model checking of "no bad state is reachable" on a
+/// SymbolicKripkeFrame. Its BDDs for I(x), T(x, x') and Bad(x) are Tseitin-
+/// encoded per time step, one multiplexer per BDD node. Depths are tried in
+/// increasing order on one incremental solver: transition steps are added
+/// permanently and the bad-state target of depth k is enabled only through
+/// an assumption literal, so learnt clauses carry over between depths.
+///
+/// The frame's BDD manager must not be used while a check runs, as node
+/// identities are cached during encoding.
+class BoundedModelChecker {
+
+private:
+    const SymbolicKripkeFrame &m_frame;
+    Bdd m_bad;
+    SatSolver m_solver;
+    int m_true = 0;
+    /// m_state_vars[t][i]: SAT variable of state bit i at step t.
+    std::vector<std::vector<int>> m_state_vars;
+    std::map<std::pair<BddManager::Node, std::size_t>, int> m_encoded;
+    std::size_t m_depth = 0;
+
+    int state_var(std::size_t step, std::uint32_t bit) {
+        while (m_state_vars.size() <= step) {
+            std::vector<int> vars(m_frame.state_bits());
+            for (auto &v: vars) {
+                v = m_solver.new_var();
+            }
+            m_state_vars.push_back(std::move(vars));
+        }
+        return m_state_vars[step][bit];
+    }
+
+    /// Literal equivalent to BDD node n with current variables at `step` and
+    /// next-state variables at step + 1.
+    int encode(BddManager::Node n, std::size_t step) {
+        if (n == BddManager::one) {
+            return m_true;
+        }
+        if (n == BddManager::zero) {
+            return -m_true;
+        }
+        if (auto it = m_encoded.find({n, step}); it != m_encoded.end()) {
+            return it->second;
+        }
+        const auto &mgr = m_frame.manager();
+        const auto bdd_var = mgr.top_var(n);
+        const int x = state_var(step + (bdd_var & 1u), bdd_var / 2);
+        const int hi = encode(mgr.high(n), step);
+        const int lo = encode(mgr.low(n), step);
+        const int out = m_solver.new_var();
+        m_solver.add_clause({-x, -hi, out});
+        m_solver.add_clause({-x, hi, -out});
+        m_solver.add_clause({x, -lo, out});
+        m_solver.add_clause({x, lo, -out});
+        m_encoded.emplace(std::pair{n, step}, out);
+        return out;
+    }
+
+public:
+    BoundedModelChecker(const SymbolicKripkeFrame &frame, Bdd bad) : m_frame(frame), m_bad(std::move(bad)) {
+        m_true = m_solver.new_var();
+        m_solver.add_clause({m_true});
+        m_solver.add_clause({encode(m_frame.initial().node(), 0)});
+    }
+
+    /// Searches for a path from an initial state to a bad state with at most
+    /// max_depth transitions, resuming from the depth reached by earlier calls.
+    std::optional<BmcCounterexample> check(std::size_t max_depth) {
+        for (; m_depth <= max_depth; ++m_depth) {
+            if (m_depth > 0) {
+                m_solver.add_clause({encode(m_frame.transitions().node(), m_depth - 1)});
+            }
+            const int target = m_solver.new_var();
+            m_solver.add_clause({-target, encode(m_bad.node(), m_depth)});
+            const int assumption[] = {target};
+            if (m_solver.solve(assumption) == SatSolver::Result::satisfiable) {
+                BmcCounterexample cex;
+                cex.depth = m_depth;
+                for (std::size_t t = 0; t <= m_depth; ++t) {
+                    std::size_t idx = 0;
+                    for (std::uint32_t i = 0; i < m_frame.state_bits(); ++i) {
+                        idx |= static_cast<std::size_t>(m_solver.model_value(state_var(t, i))) << i;
+                    }
+                    cex.states.push_back(idx);
+                }
+                return cex;
+            }
+            // The bad target of this depth is never needed again.
+            m_solver.add_clause({-target});
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] auto solver() const -> const SatSolver & {
+        return m_solver;
+    }
+};
+
+/// Row-compressed sparse matrix of doubles: the transition matrix of a DTMC,
+/// or of an MDP with one row per choice.
+class SparseMatrix {
+
+private:
+    std::vector<std::size_t> m_row_offsets{0};
+    std::vector<std::size_t> m_columns;
+    std::vector<double> m_values;
+
+public:
+    SparseMatrix() = default;
+
+    SparseMatrix(std::vector<std::size_t> row_offsets, std::vector<std::size_t> columns, std::vector<double> values)
+            : m_row_offsets(std::move(row_offsets)), m_columns(std::move(columns)), m_values(std::move(values)) {}
+
+    [[nodiscard]] std::size_t num_rows() const noexcept {
+        return m_row_offsets.size() - 1;
+    }
+
+    [[nodiscard]] std::size_t num_nonzeros() const noexcept {
+        return m_values.size();
+    }
+
+    [[nodiscard]] auto columns(std::size_t row) const -> std::span<const std::size_t> {
+        return {m_columns.data() + m_row_offsets[row], m_columns.data() + m_row_offsets[row + 1]};
+    }
+
+    [[nodiscard]] auto values(std::size_t row) const -> std::span<const double> {
+        return {m_values.data() + m_row_offsets[row], m_values.data() + m_row_offsets[row + 1]};
+    }
+
+    /// Dot product of one row with x. The loop has no branches and keeps
+    /// two independent accumulators so the compiler can vectorize it.
+    [[nodiscard]] double row_dot(std::size_t row, std::span<const double> x) const {
+        const auto *column = m_columns.data();
+        const auto *value = m_values.data();
+        const auto first = m_row_offsets[row];
+        const auto last = m_row_offsets[row + 1];
+        double even = 0;
+        double odd = 0;
+        auto k = first;
+        for (; k + 1 < last; k += 2) {
+            even += value[k] * x[column[k]];
+            odd += value[k + 1] * x[column[k + 1]];
+        }
+        if (k < last) {
+            even += value[k] * x[column[k]];
+        }
+        return even + odd;
+    }
+
+    /// y = A x, rows split over threads.
+    void multiply(std::span<const double> x, std::span<double> y) const {
+        parallel_for(0, num_rows(), [&](std::size_t row) {
+            y[row] = row_dot(row, x);
+        }, 1024);
+    }
+};
+
+
+/// A probabilistic model as the solvers see it: states own contiguous
+/// ranges of matrix rows (choices), state s owning rows
+/// [choice_offsets()[s], choice_offsets()[s + 1]).
+template<typename M>
+concept ProbabilisticModel = requires(const M &model) {
+    { model.num_states() } -> std::convertible_to<std::size_t>;
+    { model.choice_offsets() } -> std::convertible_to<std::span<const std::size_t>>;
+    { model.matrix() } -> std::convertible_to<const SparseMatrix &>;
+};
+
+
+/// Discrete-time Markov chain over a KripkeFrame: every transition carries a
+/// probability and the outgoing probabilities of a state should sum to one.
+/// Zero-probability transitions are not stored. frame() exposes the
+/// underlying graph for CTL and the other frame analyses.
+template<typename State, typename Label>
+class Dtmc {
+
+public:
+    using FrameType = KripkeFrame<State, Label>;
+
+private:
+    FrameType m_frame;
+    /// Probability of every transition, parallel to m_frame's successor lists.
+    std::vector<std::vector<double>> m_probabilities;
+
+    mutable SparseMatrix m_matrix;
+    mutable std::vector<std::size_t> m_choice_offsets;
+    mutable bool m_matrix_valid = false;
+
+    void build_matrix() const {
+        const std::size_t n = m_frame.num_states();
+        std::vector<std::size_t> offsets(n + 1, 0);
+        for (std::size_t v = 0; v < n; ++v) {
+            offsets[v + 1] = offsets[v] + m_probabilities[v].size();
+        }
+        std::vector<std::size_t> columns(offsets[n]);
+        std::vector<double> values(offsets[n]);
+        for (std::size_t v = 0; v < n; ++v) {
+            const auto succ = m_frame.successors(v);
+            std::copy(succ.begin(), succ.end(), columns.begin() + static_cast<std::ptrdiff_t>(offsets[v]));
+            std::copy(m_probabilities[v].begin(), m_probabilities[v].end(), values.begin() + static_cast<std::ptrdiff_t>(offsets[v]));
+        }
+        m_matrix = SparseMatrix(std::move(offsets), std::move(columns), std::move(values));
+        m_choice_offsets.resize(n + 1);
+        std::iota(m_choice_offsets.begin(), m_choice_offsets.end(), 0);
+        m_matrix_valid = true;
+    }
+
+public:
+    std::size_t add_state(const State &state, const Label &label) {
+        m_frame.add_state(state, label);
+        m_probabilities.emplace_back();
+        m_matrix_valid = false;
+        return m_frame.num_states() - 1;
+    }
+
+    void add_transition(std::size_t from, std::size_t to, double probability) {
+        if (probability <= 0) {
+            return;
+        }
+        m_frame.add_transition(from, to);
+        m_probabilities[from].push_back(probability);
+        m_matrix_valid = false;
+    }
+
+    [[nodiscard]] auto frame() const -> const FrameType & {
+        return m_frame;
+    }
+
+    [[nodiscard]] std::size_t num_states() const {
+        return m_frame.num_states();
+    }
+
+    [[nodiscard]] auto probabilities(std::size_t idx) const -> std::span<const double> {
+        return m_probabilities[idx];
+    }
+
+    /// Transition matrix, rebuilt on the first call after an edit; like
+    /// KripkeFrame::predecessors, that first call must not race with readers.
+    [[nodiscard]] auto matrix() const -> const SparseMatrix & {
+        if (!m_matrix_valid) {
+            build_matrix();
+        }
+        return m_matrix;
+    }
+
+    [[nodiscard]] auto choice_offsets() const -> std::span<const std::size_t> {
+        if (!m_matrix_valid) {
+            build_matrix();
+        }
+        return m_choice_offsets;
+    }
+};
+
+
+/// Markov decision process: every state has a set of choices, each a
+/// probability distribution over successors. frame() is the graph with a
+/// transition for every successor of any choice.
+template<typename State, typename Label>
+class Mdp {
+
+public:
+    using FrameType = KripkeFrame<State, Label>;
+    using Distribution = std::vector<std::pair<std::size_t, double>>;
+
+private:
+    FrameType m_frame;
+    std::vector<std::vector<Distribution>> m_choices;
+
+    mutable SparseMatrix m_matrix;
+    mutable std::vector<std::size_t> m_choice_offsets;
+    mutable bool m_matrix_valid = false;
+
+    void build_matrix() const {
+        const std::size_t n = m_frame.num_states();
+        m_choice_offsets.assign(n + 1, 0);
+        std::vector<std::size_t> offsets{0};
+        std::vector<std::size_t> columns;
+        std::vector<double> values;
+        for (std::size_t v = 0; v < n; ++v) {
+            m_choice_offsets[v + 1] = m_choice_offsets[v] + m_choices[v].size();
+            for (const auto &distribution: m_choices[v]) {
+                for (const auto &[to, probability]: distribution) {
+                    columns.push_back(to);
+                    values.push_back(probability);
+                }
+                offsets.push_back(columns.size());
+            }
+        }
+        m_matrix = SparseMatrix(std::move(offsets), std::move(columns), std::move(values));
+        m_matrix_valid = true;
+    }
+
+public:
+    std::size_t add_state(const State &state, const Label &label) {
+        m_frame.add_state(state, label);
+        m_choices.emplace_back();
+        m_matrix_valid = false;
+        return m_frame.num_states() - 1;
+    }
+
+    /// Adds a choice to state and returns its index among the state's
+    /// choices. Zero-probability entries are dropped.
+    std::size_t add_choice(std::size_t state, std::span<const std::pair<std::size_t, double>> distribution) {
+        auto &choice = m_choices[state].emplace_back();
+        for (const auto &[to, probability]: distribution) {
+            if (probability > 0) {
+                choice.emplace_back(to, probability);
+                m_frame.add_transition(state, to);
+            }
+        }
+        m_matrix_valid = false;
+        return m_choices[state].size() - 1;
+    }
+
+    [[nodiscard]] auto frame() const -> const FrameType & {
+        return m_frame;
+    }
+
+    [[nodiscard]] std::size_t num_states() const {
+        return m_frame.num_states();
+    }
+
+    [[nodiscard]] std::size_t num_choices(std::size_t state) const {
+        return m_choices[state].size();
+    }
+
+    [[nodiscard]] auto choice(std::size_t state, std::size_t idx) const -> const Distribution & {
+        return m_choices[state][idx];
+    }
+
+    /// Rows of all choices, state by state; rebuilt on the first call after an edit.
+    [[nodiscard]] auto matrix() const -> const SparseMatrix & {
+        if (!m_matrix_valid) {
+            build_matrix();
+        }
+        return m_matrix;
+    }
+
+    [[nodiscard]] auto choice_offsets() const -> std::span<const std::size_t> {
+        if (!m_matrix_valid) {
+            build_matrix();
+        }
+        return m_choice_offsets;
+    }
+};
+
+
+enum class Objective {
+    minimize, maximize
+};
+
+enum class SolverMethod {
+    /// Jacobi iteration, every sweep a parallel matrix-vector product.
+    value_iteration,
+    /// In-place sweeps that use values updated earlier in the same sweep;
+    /// fewer iterations, but sequential.
+    gauss_seidel,
+    /// Iterates a lower bound up from 0 and an upper bound down from 1 and
+    /// stops once they are within twice the precision, so the result has a
+    /// guaranteed error bound; the others only stop when progress is small.
+    interval_iteration
+};
+
+struct ReachabilityOptions {
+    SolverMethod method = SolverMethod::interval_iteration;
+    double precision = 1e-6;
+    std::size_t max_iterations = 1'000'000;
+};
+
+struct ReachabilityResult {
+    std::vector<double> probability;
+    /// Bounds on the exact value; equal to probability except for interval iteration.
+    std::vector<double> lower;
+    std::vector<double> upper;
+    std::size_t iterations = 0;
+    bool converged = false;
+};
+
+/// Maximal end components, numbered from 0; component is npos for states
+/// outside every end component.
+struct EndComponents {
+    std::vector<std::size_t> component;
+    std::size_t count = 0;
+};
+
+
+/// States whose minimal or maximal probability of reaching target is zero,
+/// found on the graph alone: a backward search for the states that can reach
+/// target (under some scheduler for maximize, under every one for minimize).
+template<ProbabilisticModel Model>
+StateSet probability_zero_states(const Model &model, const StateSet &target, Objective objective) {
+    const std::size_t n = model.num_states();
+    const auto offsets = model.choice_offsets();
+    const auto &matrix = model.matrix();
+    const std::size_t choices = offsets[n];
+
+    std::vector<std::size_t> owner(choices);
+    for (std::size_t v = 0; v < n; ++v) {
+        std::fill(owner.begin() + static_cast<std::ptrdiff_t>(offsets[v]),
+                  owner.begin() + static_cast<std::ptrdiff_t>(offsets[v + 1]), v);
+    }
+    // Reverse CSR: the choices with an entry in each column.
+    std::vector<std::size_t> rev_offsets(n + 1, 0);
+    for (std::size_t c = 0; c < choices; ++c) {
+        for (auto to: matrix.columns(c)) {
+            ++rev_offsets[to + 1];
+        }
+    }
+    std::partial_sum(rev_offsets.begin(), rev_offsets.end(), rev_offsets.begin());
+    std::vector<std::size_t> rev_choices(rev_offsets[n]);
+    {
+        auto next = rev_offsets;
+        for (std::size_t c = 0; c < choices; ++c) {
+            for (auto to: matrix.columns(c)) {
+                rev_choices[next[to]++] = c;
+            }
+        }
+    }
+
+    // A state joins once one choice (maximize) or all choices (minimize) can reach.
+    std::vector<std::size_t> pending(n);
+    for (std::size_t v = 0; v < n; ++v) {
+        pending[v] = objective == Objective::maximize ? 1 : offsets[v + 1] - offsets[v];
+    }
+    std::vector<char> choice_hit(choices, 0);
+    StateSet reaches = target;
+    std::vector<std::size_t> queue;
+    target.for_each([&](std::size_t v) { queue.push_back(v); });
+    while (!queue.empty()) {
+        const auto t = queue.back();
+        queue.pop_back();
+        for (auto k = rev_offsets[t]; k < rev_offsets[t + 1]; ++k) {
+            const auto c = rev_choices[k];
+            if (choice_hit[c]) {
+                continue;
+            }
+            choice_hit[c] = 1;
+            const auto s = owner[c];
+            if (!reaches.test(s) && --pending[s] == 0) {
+                reaches.set(s);
+                queue.push_back(s);
+            }
+        }
+    }
+    return ~reaches;
+}
+
+/// Maximal end components inside `within`: sub-MDPs that a scheduler can stay
+/// in forever with probability one. Repeatedly drops choices that can leave
+/// their state's SCC (or `within`) and states left without choices.
+template<ProbabilisticModel Model>
+EndComponents maximal_end_components(const Model &model, const StateSet &within) {
+    const std::size_t n = model.num_states();
+    const auto offsets = model.choice_offsets();
+    const auto &matrix = model.matrix();
+    std::vector<char> enabled(offsets[n], 1);
+    StateSet alive = within;
+
+    for (bool changed = true; changed;) {
+        changed = false;
+        const auto scc = strongly_connected_components(n, [&](std::size_t v, auto &&emit) {
+            if (!alive.test(v)) {
+                return;
+            }
+            for (auto c = offsets[v]; c < offsets[v + 1]; ++c) {
+                if (enabled[c]) {
+                    for (auto w: matrix.columns(c)) {
+                        emit(w);
+                    }
+                }
+            }
+        });
+        alive.for_each([&](std::size_t v) {
+            bool any = false;
+            for (auto c = offsets[v]; c < offsets[v + 1]; ++c) {
+                if (!enabled[c]) {
+                    continue;
+                }
+                const auto cols = matrix.columns(c);
+                if (std::any_of(cols.begin(), cols.end(), [&](auto w) {
+                    return !alive.test(w) || scc.component[w] != scc.component[v];
+                })) {
+                    enabled[c] = 0;
+                    changed = true;
+                } else {
+                    any = true;
+                }
+            }
+            if (!any) {
+                alive.reset(v);
+                changed = true;
+            }
+        });
+    }
+
+    EndComponents result;
+    result.component.assign(n, StateSet::npos);
+    const auto scc = strongly_connected_components(n, [&](std::size_t v, auto &&emit) {
+        if (alive.test(v)) {
+            for (auto c = offsets[v]; c < offsets[v + 1]; ++c) {
+                if (enabled[c]) {
+                    for (auto w: matrix.columns(c)) {
+                        emit(w);
+                    }
+                }
+            }
+        }
+    });
+    std::vector<std::size_t> renumber(scc.count, StateSet::npos);
+    alive.for_each([&](std::size_t v) {
+        auto &id = renumber[scc.component[v]];
+        if (id == StateSet::npos) {
+            id = result.count++;
+        }
+        result.component[v] = id;
+    });
+    return result;
+}
+
+
+/// Probabilistic reachability: the minimal or maximal (over schedulers)
+/// probability of eventually reaching target, or of reaching it within a
+/// number of steps. For a DTMC both objectives give the same result.
+template<ProbabilisticModel Model>
+class ReachabilitySolver {
+
+private:
+    const Model &m_model;
+    Objective m_objective;
+
+    [[nodiscard]] double best(double a, double b) const noexcept {
+        return m_objective == Objective::maximize ? std::max(a, b) : std::min(a, b);
+    }
+
+    /// x'[s] = opt over choices c of s of (A x)[c], with `fixed` states kept.
+    /// choice_values is scratch of one entry per choice.
+    void sweep(std::span<const double> x, std::span<double> next, std::vector<double> &choice_values,
+               const StateSet &fixed) const {
+        const auto offsets = m_model.choice_offsets();
+        m_model.matrix().multiply(x, choice_values);
+        parallel_for(0, m_model.num_states(), [&](std::size_t s) {
+            if (fixed.test(s) || offsets[s] == offsets[s + 1]) {
+                next[s] = x[s];
+                return;
+            }
+            double value = choice_values[offsets[s]];
+            for (auto c = offsets[s] + 1; c < offsets[s + 1]; ++c) {
+                value = best(value, choice_values[c]);
+            }
+            next[s] = value;
+        });
+    }
+
+    [[nodiscard]] static double max_difference(std::span<const double> a, std::span<const double> b) {
+        double diff = 0;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            diff = std::max(diff, std::abs(a[i] - b[i]));
+        }
+        return diff;
+    }
+
+    /// Lowers the upper bound of every end component to its best exit,
+    /// without which the upper iteration for maximize can get stuck at 1.
+    void deflate(std::span<double> upper, const EndComponents &ecs, std::vector<double> &exit) const {
+        const auto offsets = m_model.choice_offsets();
+        const auto &matrix = m_model.matrix();
+        exit.assign(ecs.count, 0.0);
+        for (std::size_t s = 0; s < m_model.num_states(); ++s) {
+            const auto ec = ecs.component[s];
+            if (ec == StateSet::npos) {
+                continue;
+            }
+            for (auto c = offsets[s]; c < offsets[s + 1]; ++c) {
+                const auto cols = matrix.columns(c);
+                if (std::any_of(cols.begin(), cols.end(), [&](auto w) { return ecs.component[w] != ec; })) {
+                    exit[ec] = std::max(exit[ec], matrix.row_dot(c, upper));
+                }
+            }
+        }
+        for (std::size_t s = 0; s < m_model.num_states(); ++s) {
+            if (ecs.component[s] != StateSet::npos) {
+                upper[s] = std::min(upper[s], exit[ecs.component[s]]);
+            }
+        }
+    }
+
+public:
+    explicit ReachabilitySolver(const Model &model, Objective objective = Objective::maximize)
+            : m_model(model), m_objective(objective) {}
+
+    /// Probability of eventually reaching target from every state.
+    [[nodiscard]] ReachabilityResult reach(const StateSet &target, const ReachabilityOptions &options = {}) const {
+        const std::size_t n = m_model.num_states();
+        const auto offsets = m_model.choice_offsets();
+        const auto &matrix = m_model.matrix();
+        const StateSet zero = probability_zero_states(m_model, target, m_objective);
+        const StateSet fixed = target | zero;
+
+        ReachabilityResult result;
+        auto &lower = result.lower;
+        lower.assign(n, 0.0);
+        target.for_each([&](std::size_t s) { lower[s] = 1.0; });
+        std::vector<double> next(n);
+        std::vector<double> choice_values(offsets[n]);
+
+        if (options.method == SolverMethod::gauss_seidel) {
+            while (result.iterations < options.max_iterations && !result.converged) {
+                ++result.iterations;
+                double diff = 0;
+                for (std::size_t s = 0; s < n; ++s) {
+                    if (fixed.test(s) || offsets[s] == offsets[s + 1]) {
+                        continue;
+                    }
+                    double value = matrix.row_dot(offsets[s], lower);
+                    for (auto c = offsets[s] + 1; c < offsets[s + 1]; ++c) {
+                        value = best(value, matrix.row_dot(c, lower));
+                    }
+                    diff = std::max(diff, std::abs(value - lower[s]));
+                    lower[s] = value;
+                }
+                result.converged = diff < options.precision;
+            }
+            result.probability = lower;
+            result.upper = lower;
+            return result;
+        }
+
+        if (options.method == SolverMethod::value_iteration) {
+            while (result.iterations < options.max_iterations && !result.converged) {
+                ++result.iterations;
+                sweep(lower, next, choice_values, fixed);
+                result.converged = max_difference(lower, next) < options.precision;
+                lower.swap(next);
+            }
+            result.probability = lower;
+            result.upper = lower;
+            return result;
+        }
+
+        // Interval iteration. Fixing the probability-zero states makes the
+        // fixpoint unique except inside end components under maximize, which
+        // the upper iteration has to deflate.
+        auto &upper = result.upper;
+        upper.assign(n, 1.0);
+        zero.for_each([&](std::size_t s) { upper[s] = 0.0; });
+        EndComponents ecs;
+        std::vector<double> exit;
+        if (m_objective == Objective::maximize) {
+            ecs = maximal_end_components(m_model, ~fixed);
+        }
+        while (result.iterations < options.max_iterations && !result.converged) {
+            ++result.iterations;
+            sweep(lower, next, choice_values, fixed);
+            lower.swap(next);
+            sweep(upper, next, choice_values, fixed);
+            upper.swap(next);
+            if (ecs.count != 0) {
+                deflate(upper, ecs, exit);
+            }
+            result.converged = max_difference(lower, upper) < 2 * options.precision;
+        }
+        result.probability.resize(n);
+        for (std::size_t s = 0; s < n; ++s) {
+            result.probability[s] = (lower[s] + upper[s]) / 2;
+        }
+        return result;
+    }
+
+    /// Probability of reaching target within `steps` transitions, e.g. of a
+    /// failure within k steps. Exact up to rounding: `steps` sweeps from the
+    /// target indicator.
+    [[nodiscard]] std::vector<double> reach_within(const StateSet &target, std::size_t steps) const {
+        const std::size_t n = m_model.num_states();
+        std::vector<double> x(n, 0.0);
+        target.for_each([&](std::size_t s) { x[s] = 1.0; });
+        std::vector<double> next(n);
+        std::vector<double> choice_values(m_model.choice_offsets()[n]);
+        for (std::size_t k = 0; k < steps; ++k) {
+            sweep(x, next, choice_values, target);
+            x.swap(next);
+        }
+        return x;
+    }
+};
+
+/// A max-parity game: the player owning a node picks its successor, and an
+/// infinite play is won by Even if the highest priority seen infinitely
+/// often is even. Every node needs at least one successor.
+class ParityGame {
+
+public:
+    enum class Player : std::uint8_t {
+        even, odd
+    };
+
+private:
+    std::vector<Player> m_owner;
+    std::vector<std::size_t> m_priority;
+    std::vector<std::vector<std::size_t>> m_successors;
+
+public:
+    std::size_t add_node(Player owner, std::size_t priority) {
+        m_owner.push_back(owner);
+        m_priority.push_back(priority);
+        m_successors.emplace_back();
+        return m_owner.size() - 1;
+    }
+
+    void add_edge(std::size_t from, std::size_t to) {
+        m_successors[from].push_back(to);
+    }
+
+    [[nodiscard]] std::size_t num_nodes() const noexcept {
+        return m_owner.size();
+    }
+
+    [[nodiscard]] Player owner(std::size_t node) const {
+        return m_owner[node];
+    }
+
+    [[nodiscard]] std::size_t priority(std::size_t node) const {
+        return m_priority[node];
+    }
+
+    [[nodiscard]] auto successors(std::size_t node) const -> std::span<const std::size_t> {
+        return m_successors[node];
+    }
+};
+
+struct ParityGameSolution {
+    /// Winning regions of Even and Odd; together they cover every node.
+    StateSet even;
+    StateSet odd;
+};
+
+
+/// Zielonka's recursive algorithm with attractors computed on StateSets over
+/// the game nodes. The second recursive call of the textbook version is a
+/// loop here, so recursion depth is bounded by the number of priorities.
+class ZielonkaSolver {
+
+private:
+    const ParityGame &m_game;
+    std::vector<std::size_t> m_pred_offsets;
+    std::vector<std::size_t> m_pred_sources;
+    /// Scratch for attractors: remaining successors of opponent nodes,
+    /// valid where m_stamp matches the current attractor.
+    std::vector<std::size_t> m_count;
+    std::vector<std::size_t> m_stamp;
+    std::size_t m_current = 0;
+
+    [[nodiscard]] static std::size_t index(ParityGame::Player player) noexcept {
+        return player == ParityGame::Player::even ? 0 : 1;
+    }
+
+    /// Nodes of `within` from which `player` can force a visit to target.
+    StateSet attractor(std::size_t player, const StateSet &target, const StateSet &within) {
+        ++m_current;
+        StateSet result = target;
+        std::vector<std::size_t> queue;
+        target.for_each([&](std::size_t v) { queue.push_back(v); });
+        while (!queue.empty()) {
+            const auto t = queue.back();
+            queue.pop_back();
+            for (auto k = m_pred_offsets[t]; k < m_pred_offsets[t + 1]; ++k) {
+                const auto s = m_pred_sources[k];
+                if (!within.test(s) || result.test(s)) {
+                    continue;
+                }
+                if (index(m_game.owner(s)) != player) {
+                    if (m_stamp[s] != m_current) {
+                        m_stamp[s] = m_current;
+                        const auto succ = m_game.successors(s);
+                        m_count[s] = static_cast<std::size_t>(std::count_if(succ.begin(), succ.end(), [&](auto w) {
+                            return within.test(w);
+                        }));
+                    }
+                    if (--m_count[s] != 0) {
+                        continue;
+                    }
+                }
+                result.set(s);
+                queue.push_back(s);
+            }
+        }
+        return result;
+    }
+
+    std::array<StateSet, 2> solve(StateSet nodes) {
+        std::array<StateSet, 2> won{StateSet(nodes.size()), StateSet(nodes.size())};
+        while (nodes.any()) {
+            std::size_t top = 0;
+            nodes.for_each([&](std::size_t v) { top = std::max(top, m_game.priority(v)); });
+            const std::size_t player = top % 2;
+            StateSet highest(nodes.size());
+            nodes.for_each([&](std::size_t v) {
+                if (m_game.priority(v) == top) {
+                    highest.set(v);
+                }
+            });
+            const StateSet attracted = attractor(player, highest, nodes);
+            auto sub = solve(nodes - attracted);
+            if (sub[1 - player].none()) {
+                won[player] |= nodes;
+                break;
+            }
+            const StateSet lost = attractor(1 - player, sub[1 - player], nodes);
+            won[1 - player] |= lost;
+            nodes = nodes - lost;
+        }
+        return won;
+    }
+
+public:
+    explicit ZielonkaSolver(const ParityGame &game)
+            : m_game(game), m_count(game.num_nodes()), m_stamp(game.num_nodes(), 0) {
+        const std::size_t n = game.num_nodes();
+        m_pred_offsets.assign(n + 1, 0);
+        for (std::size_t v = 0; v < n; ++v) {
+            for (auto w: game.successors(v)) {
+                ++m_pred_offsets[w + 1];
+            }
+        }
+        std::partial_sum(m_pred_offsets.begin(), m_pred_offsets.end(), m_pred_offsets.begin());
+        m_pred_sources.resize(m_pred_offsets[n]);
+        auto next = m_pred_offsets;
+        for (std::size_t v = 0; v < n; ++v) {
+            for (auto w: game.successors(v)) {
+                m_pred_sources[next[w]++] = v;
+            }
+        }
+    }
+
+    [[nodiscard]] ParityGameSolution solve() {
+        auto won = solve(StateSet(m_game.num_nodes(), true));
+        return {std::move(won[0]), std::move(won[1])};
+    }
+};
+
+
+/// Modal mu-calculus over a frame, with formulas in positive normal form
+/// built through the checker (negation only on state sets). Variables are
+/// created with variable() and bound once by mu() or nu():
+///
+///     auto x = mc.variable();
+///     auto ef_p = mc.mu(x, mc.disjunction(mc.atom(p), mc.diamond(x)));
+///
+/// evaluate() reduces model checking to a parity game over (formula, state)
+/// pairs and solves it with Zielonka's algorithm, so formulas of any
+/// alternation depth are supported.
+template<KripkeFrameLike Frame>
+class MuCalculusChecker {
+
+public:
+    using FormulaId = std::size_t;
+
+private:
+    enum class Kind {
+        states, conjunction, disjunction, diamond, box, mu, nu, variable
+    };
+
+    struct Formula {
+        Kind kind;
+        /// Operand, the set for `states`, the body of a binder, or the binder of a variable.
+        std::size_t lhs = 0;
+        /// Second operand, or the variable of a binder.
+        std::size_t rhs = 0;
+    };
+
+    static constexpr std::size_t unbound = StateSet::npos;
+
+    const Frame &m_frame;
+    std::vector<Formula> m_formulas;
+    std::vector<StateSet> m_sets;
+
+    FormulaId add(Formula formula) {
+        m_formulas.push_back(formula);
+        return m_formulas.size() - 1;
+    }
+
+    FormulaId bind(Kind kind, FormulaId var, FormulaId body) {
+        const auto binder = add({kind, body, var});
+        m_formulas[var].lhs = binder;
+        return binder;
+    }
+
+    /// Whether f has no free variables. A variable is bound only inside the
+    /// body of the binder it was last passed to, so one that was never bound,
+    /// used outside its binder, or bound twice makes the formula open.
+    [[nodiscard]] bool closed(FormulaId root) const {
+        if (root >= m_formulas.size()) {
+            return false;
+        }
+        // Free variables per subformula, memoized since formulas share subterms.
+        std::vector<std::optional<std::vector<FormulaId>>> free(m_formulas.size());
+        auto collect = [&](auto &self, FormulaId f) -> const std::vector<FormulaId> & {
+            auto &memo = free[f];
+            if (memo) {
+                return *memo;
+            }
+            const auto &formula = m_formulas[f];
+            std::vector<FormulaId> result;
+            switch (formula.kind) {
+                case Kind::conjunction:
+                case Kind::disjunction: {
+                    const auto &lhs = self(self, formula.lhs);
+                    const auto &rhs = self(self, formula.rhs);
+                    std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(result));
+                    break;
+                }
+                case Kind::diamond:
+                case Kind::box:
+                    result = self(self, formula.lhs);
+                    break;
+                case Kind::mu:
+                case Kind::nu:
+                    result = self(self, formula.lhs);
+                    if (m_formulas[formula.rhs].lhs == f) {
+                        std::erase(result, formula.rhs);
+                    }
+                    break;
+                case Kind::variable:
+                    result.push_back(f);
+                    break;
+                case Kind::states:
+                    break;
+            }
+            return *(free[f] = std::move(result));
+        };
+        return collect(collect, root).empty();
+    }
+
+    /// Binder nesting height: binders nested inside a binder's body
+    /// (syntactically, not through variables) get a smaller height, so outer
+    /// fixpoints get the larger priorities.
+    std::size_t height(FormulaId f, std::vector<std::size_t> &memo) const {
+        if (memo[f] != unbound) {
+            return memo[f];
+        }
+        const auto &formula = m_formulas[f];
+        std::size_t h = 0;
+        switch (formula.kind) {
+            case Kind::conjunction:
+            case Kind::disjunction:
+                h = std::max(height(formula.lhs, memo), height(formula.rhs, memo));
+                break;
+            case Kind::diamond:
+            case Kind::box:
+                h = height(formula.lhs, memo);
+                break;
+            case Kind::mu:
+            case Kind::nu:
+                h = height(formula.lhs, memo) + 1;
+                break;
+            case Kind::states:
+            case Kind::variable:
+                break;
+        }
+        return memo[f] = h;
+    }
+
+public:
+    explicit MuCalculusChecker(const Frame &frame) : m_frame(frame) {}
+
+    FormulaId states(StateSet set) {
+        m_sets.push_back(std::move(set));
+        return add({Kind::states, m_sets.size() - 1});
+    }
+
+    FormulaId constant(bool value) {
+        return states(StateSet(m_frame.num_states(), value));
+    }
+
+    FormulaId atom(std::size_t prop) requires Frame::has_proposition_labels {
+        return states(StateSet(m_frame.states_with(prop)));
+    }
+
+    FormulaId negated_atom(std::size_t prop) requires Frame::has_proposition_labels {
+        return states(~StateSet(m_frame.states_with(prop)));
+    }
+
+    FormulaId conjunction(FormulaId f, FormulaId g) {
+        return add({Kind::conjunction, f, g});
+    }
+
+    FormulaId disjunction(FormulaId f, FormulaId g) {
+        return add({Kind::disjunction, f, g});
+    }
+
+    /// <>f: some successor satisfies f.
+    FormulaId diamond(FormulaId f) {
+        return add({Kind::diamond, f});
+    }
+
+    /// []f: every successor satisfies f.
+    FormulaId box(FormulaId f) {
+        return add({Kind::box, f});
+    }
+
+    FormulaId variable() {
+        return add({Kind::variable, unbound});
+    }
+
+    /// Least fixpoint mu var. body; var must not be bound yet, or the
+    /// formula stops being closed.
+    FormulaId mu(FormulaId var, FormulaId body) {
+        return bind(Kind::mu, var, body);
+    }
+
+    /// Greatest fixpoint nu var. body; var must not be bound yet, or the
+    /// formula stops being closed.
+    FormulaId nu(FormulaId var, FormulaId body) {
+        return bind(Kind::nu, var, body);
+    }
+
+    /// The game for a closed formula: Even (the verifier) moves at
+    /// disjunctions and diamonds, Odd at conjunctions and boxes, binders get
+    /// priority 2 * height (+1 for mu), and moves that decide the game
+    /// immediately lead to one of two sinks. Node f * n + s stands for
+    /// formula f at state s. Returns the game and the formula-local index of
+    /// every formula reachable from f, or nullopt if f is not closed.
+    [[nodiscard]] auto build_game(FormulaId root) const -> std::optional<std::pair<ParityGame, std::vector<std::size_t>>> {
+        if (!closed(root)) {
+            return std::nullopt;
+        }
+        const std::size_t n = m_frame.num_states();
+        std::vector<std::size_t> local(m_formulas.size(), unbound);
+        std::vector<FormulaId> order{root};
+        local[root] = 0;
+        for (std::size_t head = 0; head < order.size(); ++head) {
+            const auto &formula = m_formulas[order[head]];
+            auto reach = [&](FormulaId g) {
+                if (local[g] == unbound) {
+                    local[g] = order.size();
+                    order.push_back(g);
+                }
+            };
+            switch (formula.kind) {
+                case Kind::conjunction:
+                case Kind::disjunction:
+                    reach(formula.lhs);
+                    reach(formula.rhs);
+                    break;
+                case Kind::diamond:
+                case Kind::box:
+                case Kind::mu:
+                case Kind::nu:
+                case Kind::variable:
+                    reach(formula.lhs);
+                    break;
+                case Kind::states:
+                    break;
+            }
+        }
+        std::vector<std::size_t> memo(m_formulas.size(), unbound);
+
+        using Player = ParityGame::Player;
+        ParityGame game;
+        for (auto f: order) {
+            const auto &formula = m_formulas[f];
+            const bool universal = formula.kind == Kind::conjunction || formula.kind == Kind::box;
+            std::size_t priority = 0;
+            if (formula.kind == Kind::mu || formula.kind == Kind::nu) {
+                priority = 2 * height(f, memo) + (formula.kind == Kind::mu ? 1 : 0);
+            }
+            for (std::size_t s = 0; s < n; ++s) {
+                game.add_node(universal ? Player::odd : Player::even, priority);
+            }
+        }
+        const auto even_wins = game.add_node(Player::even, 0);
+        const auto odd_wins = game.add_node(Player::odd, 1);
+        game.add_edge(even_wins, even_wins);
+        game.add_edge(odd_wins, odd_wins);
+
+        for (auto f: order) {
+            const auto &formula = m_formulas[f];
+            const auto base = local[f] * n;
+            for (std::size_t s = 0; s < n; ++s) {
+                const auto node = base + s;
+                switch (formula.kind) {
+                    case Kind::states:
+                        game.add_edge(node, m_sets[formula.lhs].test(s) ? even_wins : odd_wins);
+                        break;
+                    case Kind::conjunction:
+                    case Kind::disjunction:
+                        game.add_edge(node, local[formula.lhs] * n + s);
+                        game.add_edge(node, local[formula.rhs] * n + s);
+                        break;
+                    case Kind::diamond:
+                    case Kind::box: {
+                        const auto succ = m_frame.successors(s);
+                        if (succ.empty()) {
+                            game.add_edge(node, formula.kind == Kind::box ? even_wins : odd_wins);
+                        }
+                        for (auto t: succ) {
+                            game.add_edge(node, local[formula.lhs] * n + t);
+                        }
+                        break;
+                    }
+                    case Kind::mu:
+                    case Kind::nu:
+                    case Kind::variable:
+                        game.add_edge(node, local[formula.lhs] * n + s);
+                        break;
+                }
+            }
+        }
+        return std::pair{std::move(game), std::move(local)};
+    }
+
+    /// States satisfying f, or nullopt if f is not closed.
+    [[nodiscard]] std::optional<StateSet> evaluate(FormulaId f) const {
+        const std::size_t n = m_frame.num_states();
+        const auto built = build_game(f);
+        if (!built) {
+            return std::nullopt;
+        }
+        const auto &[game, local] = *built;
+        const auto solution = ZielonkaSolver(game).solve();
+        StateSet result(n);
+        for (std::size_t s = 0; s < n; ++s) {
+            result.set(s, solution.even.test(local[f] * n + s));
+        }
+        return result;
+    }
+};
+
+/* Template class for "Expression" */
+template<typename T>
+class Expression {
+public:
+    [[nodiscard]] virtual T evaluate() const = 0;
+
+    virtual ~Expression() = default;
+};
+
+// Constant Expression
+template<typename T>
+class Constant : public Expression<T> {
+private:
+    T m_value;
+public:
+    explicit Constant(T value) : m_value(value) {}
+
+    T evaluate() const override {
+        return m_value;
+    }
+};
+
+// Mutable Expression
+template<typename T>
+class Mutable : public Expression<T> {
+private:
+    T m_value;
+public:
+    explicit Mutable(T value) : m_value(value) {}
+
+    T evaluate() const override {
+        return m_value;
+    }
+
+    void set(T value) {
+        m_value = value;
+    }
+};
+
+// Binary Expression
+template<typename T, typename Op>
+class Binary : public Expression<T> {
+private:
+    std::unique_ptr<Expression<T>> m_left;
+    std::unique_ptr<Expression<T>> m_right;
+public:
+    Binary(std::unique_ptr<Expression<T>> left, std::unique_ptr<Expression<T>> right) :
+            m_left(std::move(left)), m_right(std::move(right)) {}
+
+    T evaluate() const override {
+        return Op::apply(m_left->evaluate(), m_right->evaluate());
+    }
+};
+
+// Unary Expression
+template<typename T, typename Op>
+class Unary : public Expression<T> {
+private:
+    std::unique_ptr<Expression<T>> m_expr;
+public:
+    explicit Unary(std::unique_ptr<Expression<T>> expr) : m_expr(std::move(expr)) {}
+
+    T evaluate() const override {
+        return Op::apply(m_expr->evaluate());
+    }
+};
+
+// NAry Expression
+template<typename T, typename Op>
+class NAry : public Expression<T> {
+private:
+    std::vector<std::unique_ptr<Expression<T>>> m_exprs;
+public:
+    explicit NAry(std::vector<std::unique_ptr<Expression<T>>> exprs) : m_exprs(std::move(exprs)) {}
+
+    T evaluate() const override {
+        return Op::apply(m_exprs);
+    }
+};
+
+// Binary Operators
+template<typename T>
+struct Add {
+    static T apply(T left, T right) {
+        return left + right;
+    }
+};
+
+template<typename T>
+struct Subtract {
+    static T apply(T left, T right) {
+        return left - right;
+    }
+};
+
+template<typename T>
+struct Multiply {
+    static T apply(T left, T right) {
+        return left * right;
+    }
+};
+
+template<typename T>
+struct Divide {
+    static T apply(T left, T right) {
+        return left / right;
+    }
+};
+
+template<typename T, std::size_t N>
+struct Modulo {
+    static T apply(T left, T right) {
+        return left % right;
+    }
+};
+
+template<typename T, std::size_t N>
+struct Power {
+    static T apply(T left, T right) {
+        return std::pow(left, right);
+    }
+};
@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "lake.hpp"
+
+
+/// Checks that stay active in release builds; failures are counted and
+/// reported, and main returns non-zero if there were any.
+static int failures = 0;
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition "\n"; \
+            ++failures;                                                                   \
+        }                                                                                 \
+    } while (false)
+
+using TestFrame = KripkeFrame<std::size_t, PropositionLabel<2>>;
+
+
+// --- SatSolver ---
+
+static bool solve_dimacs(SatSolver &solver, const std::string &text) {
+    std::istringstream in(text);
+    return solver.read_dimacs(in);
+}
+
+/// Pigeons p (0..holes) in holes h; variable p * holes + h + 1 places p in h.
+static void add_pigeonhole(SatSolver &solver, int holes) {
+    const int pigeons = holes + 1;
+    auto var = [&](int p, int h) { return p * holes + h + 1; };
+    for (int p = 0; p < pigeons; ++p) {
+        std::vector<int> somewhere;
+        for (int h = 0; h < holes; ++h) {
+            somewhere.push_back(var(p, h));
+        }
+        solver.add_clause(somewhere);
+    }
+    for (int h = 0; h < holes; ++h) {
+        for (int p = 0; p < pigeons; ++p) {
+            for (int q = p + 1; q < pigeons; ++q) {
+                solver.add_clause({-var(p, h), -var(q, h)});
+            }
+        }
+    }
+}
+
+static void test_sat_solver() {
+    {
+        SatSolver solver;
+        add_pigeonhole(solver, 5);
+        CHECK(solver.solve() == SatSolver::Result::unsatisfiable);
+    }
+    {
+        SatSolver solver;
+        CHECK(solve_dimacs(solver, "c pigeonhole 3 into 2\np cnf 6 9\n1 2 0\n3 4 0\n5 6 0\n"
+                                   "-1 -3 0\n-1 -5 0\n-3 -5 0\n-2 -4 0\n-2 -6 0\n-4 -6 0\n"));
+        CHECK(solver.solve() == SatSolver::Result::unsatisfiable);
+    }
+    {
+        // Random 3-SAT with a planted solution, so it is satisfiable; the
+        // model found must satisfy every clause.
+        std::mt19937_64 rng(7);
+        constexpr int vars = 150;
+        std::vector<bool> planted(vars + 1);
+        for (int v = 1; v <= vars; ++v) {
+            planted[v] = rng() % 2;
+        }
+        std::vector<std::vector<int>> clauses;
+        while (clauses.size() < 600) {
+            std::vector<int> clause;
+            bool satisfied = false;
+            for (int k = 0; k < 3; ++k) {
+                const int v = static_cast<int>(rng() % vars) + 1;
+                const int lit = rng() % 2 ? v : -v;
+                satisfied = satisfied || (lit > 0) == planted[v];
+                clause.push_back(lit);
+            }
+            if (satisfied) {
+                clauses.push_back(std::move(clause));
+            }
+        }
+        SatSolver solver;
+        for (const auto &clause: clauses) {
+            solver.add_clause(clause);
+        }
+        CHECK(solver.solve() == SatSolver::Result::satisfiable);
+        for (const auto &clause: clauses) {
+            CHECK(std::any_of(clause.begin(), clause.end(), [&](int lit) {
+                return solver.model_value(std::abs(lit)) == (lit > 0);
+            }));
+        }
+    }
+    {
+        // Assumptions restrict one solve only.
+        SatSolver solver;
+        CHECK(solve_dimacs(solver, "p cnf 3 2\n1 2 0\n-2 3 0\n%\n0\n"));
+        const int both_false[] = {-1, -2};
+        CHECK(solver.solve(both_false) == SatSolver::Result::unsatisfiable);
+        const int first_false[] = {-1};
+        CHECK(solver.solve(first_false) == SatSolver::Result::satisfiable);
+        CHECK(!solver.model_value(1) && solver.model_value(2) && solver.model_value(3));
+        const int conflict[] = {-3, 2};
+        CHECK(solver.solve(conflict) == SatSolver::Result::unsatisfiable);
+        CHECK(solver.solve() == SatSolver::Result::satisfiable);
+    }
+    {
+        SatSolver solver;
+        CHECK(!solve_dimacs(solver, "p cnf 2 1\n1 x 0\n"));
+        CHECK(!solve_dimacs(solver, "p cnf 2 1\n1 2"));
+    }
+}
+
+
+// --- BoundedModelChecker ---
+
+static void test_bounded_model_checker() {
+    // A 3-bit counter from 0 that wraps at 8; state 5 is bad.
+    SymbolicKripkeFrame frame(3);
+    Bdd step = frame.manager().constant(false);
+    for (std::size_t v = 0; v < 8; ++v) {
+        Bdd target = frame.manager().constant(true);
+        const auto w = (v + 1) % 8;
+        for (std::uint32_t i = 0; i < 3; ++i) {
+            target &= ((w >> i) & 1u) ? frame.next_var(i) : !frame.next_var(i);
+        }
+        step |= frame.state(v) & target;
+    }
+    frame.add_transitions(step);
+    frame.add_initial(frame.state(0));
+    const Bdd bad = frame.state(5);
+
+    BoundedModelChecker shallow(frame, bad);
+    CHECK(!shallow.check(4));
+    const auto found = shallow.check(10);
+    CHECK(found && found->depth == 5);
+    if (found) {
+        CHECK((found->states == std::vector<std::size_t>{0, 1, 2, 3, 4, 5}));
+    }
+
+    BoundedModelChecker unreachable(frame, frame.manager().constant(false));
+    CHECK(!unreachable.check(12));
+}
+
+
+// --- ReachabilitySolver ---
+
+static bool near(double a, double b) {
+    return std::abs(a - b) < 1e-5;
+}
+
+static void test_reachability_solver() {
+    // Gambler's ruin on 0..3 with fair coin flips: reaching 3 from 1 has
+    // probability 1/3 and from 2 probability 2/3.
+    Dtmc<int, int> chain;
+    for (int s = 0; s < 4; ++s) {
+        chain.add_state(s, 0);
+    }
+    chain.add_transition(0, 0, 1.0);
+    chain.add_transition(3, 3, 1.0);
+    for (std::size_t s: {1, 2}) {
+        chain.add_transition(s, s - 1, 0.5);
+        chain.add_transition(s, s + 1, 0.5);
+    }
+    StateSet goal(4);
+    goal.set(3);
+    const ReachabilitySolver dtmc(chain);
+    for (auto method: {SolverMethod::value_iteration, SolverMethod::gauss_seidel, SolverMethod::interval_iteration}) {
+        ReachabilityOptions options;
+        options.method = method;
+        options.precision = 1e-9;
+        const auto result = dtmc.reach(goal, options);
+        CHECK(result.converged);
+        CHECK(near(result.probability[0], 0.0) && near(result.probability[1], 1.0 / 3) &&
+              near(result.probability[2], 2.0 / 3) && near(result.probability[3], 1.0));
+    }
+    const auto within = dtmc.reach_within(goal, 3);
+    CHECK(near(within[1], 0.25) && near(within[2], 0.5 + 0.125));
+
+    // State 0 can gamble (a), retry (b), or idle forever (c); 1 is the goal
+    // and 2 a sink. Max picks b until it succeeds: 1. Min idles: 0.
+    Mdp<int, int> mdp;
+    for (int s = 0; s < 3; ++s) {
+        mdp.add_state(s, 0);
+    }
+    const std::pair<std::size_t, double> gamble[] = {{1, 0.5}, {2, 0.5}};
+    const std::pair<std::size_t, double> retry[] = {{1, 0.2}, {0, 0.8}};
+    const std::pair<std::size_t, double> idle[] = {{0, 1.0}};
+    const std::pair<std::size_t, double> stay_goal[] = {{1, 1.0}};
+    const std::pair<std::size_t, double> stay_sink[] = {{2, 1.0}};
+    mdp.add_choice(0, gamble);
+    mdp.add_choice(0, retry);
+    mdp.add_choice(0, idle);
+    mdp.add_choice(1, stay_goal);
+    mdp.add_choice(2, stay_sink);
+    StateSet target(3);
+    target.set(1);
+    for (auto method: {SolverMethod::value_iteration, SolverMethod::gauss_seidel, SolverMethod::interval_iteration}) {
+        ReachabilityOptions options;
+        options.method = method;
+        options.precision = 1e-9;
+        const auto max = ReachabilitySolver(mdp, Objective::maximize).reach(target, options);
+        const auto min = ReachabilitySolver(mdp, Objective::minimize).reach(target, options);
+        CHECK(max.converged && min.converged);
+        CHECK(near(max.probability[0], 1.0) && near(min.probability[0], 0.0));
+        CHECK(near(max.probability[2], 0.0) && near(min.probability[1], 1.0));
+    }
+    const auto interval = ReachabilitySolver(mdp, Objective::maximize).reach(target);
+    CHECK(interval.lower[0] <= 1.0 && interval.upper[0] >= interval.lower[0] && interval.upper[0] - interval.lower[0] < 1e-5);
+}
+
+
+// --- MuCalculusChecker ---
+
+static void test_mu_calculus_against_ctl() {
+    std::mt19937_64 rng(11);
+    for (int round = 0; round < 200; ++round) {
+        const std::size_t n = 1 + rng() % 25;
+        TestFrame frame;
+        for (std::size_t v = 0; v < n; ++v) {
+            frame.add_state(v, PropositionLabel<2>(rng() % 4));
+        }
+        for (std::size_t e = 0; e < 2 * n; ++e) {
+            frame.add_transition(rng() % n, rng() % n);
+        }
+        for (std::size_t v = 0; v < n; ++v) {
+            if (frame.successors(v).empty()) {
+                frame.add_transition(v, v);
+            }
+        }
+
+        CtlChecker ctl(frame);
+        const auto p = ctl.atom(0);
+        const auto q = ctl.atom(1);
+        MuCalculusChecker mu(frame);
+        auto fixpoint = [&](bool least, auto &&body) {
+            const auto x = mu.variable();
+            return least ? mu.mu(x, body(x)) : mu.nu(x, body(x));
+        };
+        const auto mp = mu.atom(0);
+        const auto mq = mu.atom(1);
+        const auto ef = fixpoint(true, [&](auto x) { return mu.disjunction(mp, mu.diamond(x)); });
+        const auto eg = fixpoint(false, [&](auto x) { return mu.conjunction(mp, mu.diamond(x)); });
+        const auto ag = fixpoint(false, [&](auto x) { return mu.conjunction(mp, mu.box(x)); });
+        const auto eu = fixpoint(true, [&](auto x) { return mu.disjunction(mq, mu.conjunction(mp, mu.diamond(x))); });
+        // nu Z. mu Y. <>((q & Z) | Y): some path visits q infinitely often,
+        // which is fair EG true under the Buchi constraint q.
+        const auto z = mu.variable();
+        const auto inner = fixpoint(true, [&](auto y) { return mu.diamond(mu.disjunction(mu.conjunction(mq, z), y)); });
+        const auto egf = mu.nu(z, inner);
+        FairCtlChecker fair(frame);
+        fair.add_buchi(1);
+
+        CHECK(mu.evaluate(ef) == ctl.ef(p));
+        CHECK(mu.evaluate(eg) == ctl.eg(p));
+        CHECK(mu.evaluate(ag) == ctl.ag(p));
+        CHECK(mu.evaluate(eu) == ctl.eu(p, q));
+        CHECK(mu.evaluate(egf) == fair.fair());
+    }
+}
+
+
+int main() {
+    test_sat_solver();
+    test_bounded_model_checker();
+    test_reachability_solver();
+    test_mu_calculus_against_ctl();
+    if (failures != 0) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}